@@ -523,6 +523,9 @@ static void player_wipe(void)
         l_ptr->pkills = 0;
     }
 
+    /* The cached allocation bands are stale */
+    alloc_race_stamp++;
+
     /*No current player ghosts*/
     bones_selector = 0;
 
@@ -1477,12 +1480,13 @@ static bool player_birth_aux_1(void)
         op_ptr->opt[OPT_SCORE + (i - OPT_CHEAT)] = op_ptr->opt[i];
     }
 
-    // Set a default value for hitpoint warning / delay factor unless this is an
-    // old game file
+    // Set a default value for hitpoint warning / delay factor / frame budget
+    // unless this is an old game file
     if (strlen(op_ptr->full_name) == 0)
     {
         op_ptr->hitpoint_warn = 3;
         op_ptr->delay_factor = 5;
+        op_ptr->frame_budget = 3;
     }
 
     /* reset squelch bits */
@@ -1971,6 +1975,99 @@ static bool player_birth_aux(void)
     return (TRUE);
 }
 
+/*
+ * Create a new character without asking any questions.
+ *
+ * This is used by the headless benchmark (see "main-bench.c"), which
+ * needs a repeatable character to drive the game loop.  The race is
+ * given by index, and an illegal house falls back to the first house
+ * that the race allows.  Stats use a fixed point-buy spread and the
+ * starting experience is left unspent.
+ */
+void player_birth_quick(int race, int house)
+{
+    int i;
+
+    /* A legal point-buy spread (11 of the 13 points) */
+    static const int stats[A_MAX] = { 3, 2, 1, 1 };
+
+    /* Wipe the player */
+    player_wipe();
+
+    /* Set race */
+    if ((race < 0) || (race >= z_info->p_max))
+        race = 0;
+    p_ptr->prace = race;
+    rp_ptr = &p_info[p_ptr->prace];
+
+    /* Set house */
+    if (rp_ptr->choice & 1)
+    {
+        house = 0;
+    }
+    else if ((house < 0) || (house >= z_info->c_max)
+        || !(rp_ptr->choice & (1L << house)))
+    {
+        for (house = 0; house < z_info->c_max; house++)
+        {
+            if (rp_ptr->choice & (1L << house))
+                break;
+        }
+    }
+    p_ptr->phouse = house;
+    hp_ptr = &c_info[p_ptr->phouse];
+
+    /* Set adult options from birth options */
+    for (i = OPT_BIRTH; i < OPT_CHEAT; i++)
+    {
+        op_ptr->opt[OPT_ADULT + (i - OPT_BIRTH)] = op_ptr->opt[i];
+    }
+
+    /* Reset score options from cheat options */
+    for (i = OPT_CHEAT; i < OPT_ADULT; i++)
+    {
+        op_ptr->opt[OPT_SCORE + (i - OPT_CHEAT)] = op_ptr->opt[i];
+    }
+
+    /* Set the stats */
+    for (i = 0; i < A_MAX; i++)
+    {
+        p_ptr->stat_base[i] = stats[i] + rp_ptr->r_adj[i] + hp_ptr->h_adj[i];
+        p_ptr->stat_drain[i] = 0;
+    }
+
+    /* Roll the rest */
+    get_extra();
+    get_history_aux();
+    get_ahw_aux();
+
+    /* Calculate the bonuses and hitpoints */
+    p_ptr->update |= (PU_BONUS | PU_HP);
+
+    /* Update stuff */
+    update_stuff();
+
+    /* Fully healed */
+    p_ptr->chp = p_ptr->mhp;
+
+    /* Fully rested */
+    calc_voice();
+    p_ptr->csp = p_ptr->msp;
+
+    // Reset the number of artefacts
+    p_ptr->artefacts = 0;
+
+    /* Nothing is left to come from the old savefile */
+    load_notes();
+    for (i = 0; i < NOTES_LENGTH; i++)
+    {
+        notes_buffer[i] = '\0';
+    }
+
+    /* Hack -- outfit the player */
+    player_outfit();
+}
+
 /*
  * Create a new character.
  *
@@ -1997,6 +2094,8 @@ void player_birth()
             break;
     }
 
+    /* Nothing is left to come from the old savefile */
+    load_notes();
     for (i = 0; i < NOTES_LENGTH; i++)
     {
         notes_buffer[i] = '\0';
@@ -10,6 +10,15 @@
 
 #include "angband.h"
 
+/*
+ * Use SSE2 for the grid kernels where the compiler is sure to have it
+ */
+#if defined(__SSE2__) || defined(_M_X64)                                       \
+    || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define GRID_SSE2
+#include <emmintrin.h>
+#endif
+
 /*
  * Support for tilesets, lighting and transparency effects
  * by Robert Ruehlmann (rr9@thangorodrim.net)
@@ -54,6 +63,50 @@ int distance_squared(int y1, int x1, int y2, int x2)
     return (ay * ay + ax * ax);
 }
 
+/*
+ * The "los()" cache.
+ *
+ * Each entry remembers the endpoints of a line of sight and the result,
+ * stamped with the value of "los_cache_gen" when it was traced.  Whenever
+ * a grid changes between wall and floor the generation moves on, which
+ * forgets every entry at once.  Lines can't be stored in both directions,
+ * as "los()" isn't quite symmetric for "knight moves".
+ */
+static u32b los_cache_key[LOS_CACHE_SIZE];
+static u32b los_cache_stamp[LOS_CACHE_SIZE];
+static u32b los_cache_gen = 1;
+static u32b los_cache_hits = 0;
+static u32b los_cache_misses = 0;
+static u32b los_cache_resets = 0;
+
+/*
+ * Forget all of the cached lines of sight
+ *
+ * This must be called whenever CAVE_WALL changes without using
+ * "cave_set_feat()".
+ */
+void los_cache_forget(void)
+{
+    los_cache_resets++;
+
+    /* Wipe the stamps when the generation wraps */
+    if (++los_cache_gen >= 0x80000000L)
+    {
+        (void)C_WIPE(los_cache_stamp, LOS_CACHE_SIZE, u32b);
+        los_cache_gen = 1;
+    }
+}
+
+/*
+ * Report how well the "los()" cache has been doing (for debugging)
+ */
+void los_cache_stats(u32b* hits, u32b* misses, u32b* resets)
+{
+    *hits = los_cache_hits;
+    *misses = los_cache_misses;
+    *resets = los_cache_resets;
+}
+
 /*
  * A simple, fast, integer-based line-of-sight algorithm.  By Joseph Hall,
  * 4116 Brewster Drive, Raleigh NC 27606.  Email to jnh@ecemwl.ncsu.edu.
@@ -90,7 +143,7 @@ int distance_squared(int y1, int x1, int y2, int x2)
  * determining which grids are illuminated by the player's torch, and which
  * grids and monsters can be "seen" by the player, etc).
  */
-bool los(int y1, int x1, int y2, int x2)
+static bool los_trace(int y1, int x1, int y2, int x2)
 {
     /* Delta */
     int dx, dy;
@@ -312,6 +365,43 @@ bool los(int y1, int x1, int y2, int x2)
     return (TRUE);
 }
 
+/*
+ * Determine if a line of sight can be traced from (y1,x1) to (y2,x2),
+ * remembering the answer in the "los()" cache (see "los_trace()").
+ */
+bool los(int y1, int x1, int y2, int x2)
+{
+    u32b key;
+    int i;
+    bool result;
+
+    /* Handle adjacent (or identical) grids */
+    if ((ABS(y2 - y1) < 2) && (ABS(x2 - x1) < 2))
+        return (TRUE);
+
+    /* Hash the endpoints */
+    key = ((u32b)y1 << 24) | ((u32b)x1 << 16) | ((u32b)y2 << 8) | (u32b)x2;
+    i = (int)(((key * 2654435761UL) & 0xFFFFFFFFUL) >> (32 - LOS_CACHE_BITS));
+
+    /* Already known */
+    if ((los_cache_key[i] == key)
+        && ((los_cache_stamp[i] >> 1) == los_cache_gen))
+    {
+        los_cache_hits++;
+        return ((bool)(los_cache_stamp[i] & 1));
+    }
+
+    los_cache_misses++;
+
+    result = los_trace(y1, x1, y2, x2);
+
+    /* Remember it */
+    los_cache_key[i] = key;
+    los_cache_stamp[i] = (los_cache_gen << 1) | (result ? 1 : 0);
+
+    return (result);
+}
+
 void random_unseen_floor(int* ry, int* rx)
 {
     int i, y, x;
@@ -775,6 +865,168 @@ int player_tile_offset()
 }
 
 
+/*
+ * Cache of the terrain glyphs worked out by "map_info()"
+ *
+ * The terrain part of a grid's appearance only depends on its feature, on
+ * its "CAVE_MARK", "CAVE_SEEN" and "CAVE_HIDDEN" flags (the last decides
+ * whether a trap looks like floor), on whether it is lit, and on a few
+ * global modes.  Each grid remembers all of these (as a "stamp") along with
+ * the glyph they gave, so redrawing an unchanged grid (as when the panel
+ * scrolls) costs a comparison, and any change to the grid, through
+ * "cave_set_feat()", "note_spot()", "update_view()" and so on, is noticed
+ * without having to be reported.  Only changes to the feature visuals have
+ * to call "map_info_forget()".
+ */
+static u32b map_glyph_key[MAX_DUNGEON_HGT][MAX_DUNGEON_WID];
+static byte map_glyph_a[MAX_DUNGEON_HGT][MAX_DUNGEON_WID];
+static char map_glyph_c[MAX_DUNGEON_HGT][MAX_DUNGEON_WID];
+static u32b map_glyph_gen = 1;
+
+/*
+ * Forget every cached terrain glyph (when the feature visuals change)
+ */
+void map_info_forget(void)
+{
+    /* Wipe the stamps when the generation wraps */
+    if (++map_glyph_gen >= 0x0800L)
+    {
+        (void)C_WIPE(
+            &map_glyph_key[0][0], MAX_DUNGEON_HGT * MAX_DUNGEON_WID, u32b);
+        map_glyph_gen = 1;
+    }
+}
+
+/*
+ * Everything the terrain glyph of a grid depends on
+ */
+static u32b map_glyph_stamp(byte feat, u16b info, int light, bool rage_active)
+{
+    u32b key = feat;
+
+    if (info & (CAVE_MARK))
+        key |= 0x0100;
+    if (info & (CAVE_SEEN))
+        key |= 0x0200;
+    if (light > 0)
+        key |= 0x0400;
+    if (p_ptr->blind)
+        key |= 0x0800;
+    if (rage_active)
+        key |= 0x1000;
+    if (use_background_colors)
+        key |= 0x2000;
+    if (hybrid_walls)
+        key |= 0x4000;
+    if (solid_walls)
+        key |= 0x8000;
+
+    key |= (u32b)(use_graphics & 0x0F) << 16;
+    if (info & (CAVE_HIDDEN))
+        key |= 0x100000L;
+    key |= map_glyph_gen << 21;
+
+    return (key);
+}
+
+/*
+ * Work out the terrain glyph of a known grid (see "map_info()")
+ */
+static void map_terrain(int y, int x, byte feat, u16b info, bool rage_active,
+    byte* ap, char* cp)
+{
+    byte a = TERM_DARK;
+    char c = ' ';
+
+    feature_type* f_ptr;
+
+    /* Boring grids (floors, etc) */
+    if (cave_floorlike_bold(y, x))
+    {
+        /* Memorized (or seen) floor */
+        if ((info & (CAVE_MARK)) || (info & (CAVE_SEEN)))
+        {
+            int feat = FEAT_FLOOR;
+
+            if (rage_active && !graphics_are_ascii())
+            {
+                feat = FEAT_RAGE_FLOOR;
+            }
+
+            /* Get the floor feature */
+            f_ptr = &f_info[feat];
+
+            /* Normal attr */
+            a = f_ptr->x_attr;
+
+            /* Normal char */
+            c = f_ptr->x_char;
+
+            /* Skip special light for the player tile. */
+            special_lighting_floor(&a, &c, info, cave_light[y][x]);
+        }
+
+        /* Unknown */
+        else
+        {
+            /* Get the darkness feature */
+            f_ptr = &f_info[FEAT_NONE];
+
+            /* Normal attr */
+            a = f_ptr->x_attr;
+
+            /* Normal char */
+            c = f_ptr->x_char;
+        }
+    }
+
+    /* Interesting grids (non-floors) */
+    else
+    {
+        /* Memorized grids */
+        if (info & (CAVE_MARK))
+        {
+            /* Apply "mimic" field */
+            feat = f_info[feat].mimic;
+
+            if (rage_active && !graphics_are_ascii()
+                && (feat >= FEAT_WALL_HEAD && feat <= FEAT_WALL_TAIL))
+            {
+                feat = FEAT_RAGE_WALL;
+            }
+
+            /* Get the feature */
+            f_ptr = &f_info[feat];
+
+            /* Normal attr */
+            a = f_ptr->x_attr;
+
+            /* Normal char */
+            c = f_ptr->x_char;
+
+            /* Special lighting effects (walls only) */
+            special_lighting_wall(&a, &c, feat, info);
+        }
+
+        /* Unknown */
+        else
+        {
+            /* Get the darkness feature */
+            f_ptr = &f_info[FEAT_NONE];
+
+            /* Normal attr */
+            a = f_ptr->x_attr;
+
+            /* Normal char */
+            c = f_ptr->x_char;
+        }
+    }
+
+
+    (*ap) = a;
+    (*cp) = c;
+}
+
 /*
  * Extract the attr/char to display at the given (legal) map location
  *
@@ -975,86 +1227,29 @@ void map_info(int y, int x, byte* ap, char* cp, byte* tap, char* tcp)
         c = f_ptr->x_char;
     }
 
-    /* Boring grids (floors, etc) */
-    else if (cave_floorlike_bold(y, x))
+    /* Known grids */
+    else
     {
-        /* Memorized (or seen) floor */
-        if ((info & (CAVE_MARK)) || (info & (CAVE_SEEN)))
-        {
-            int feat = FEAT_FLOOR;
-
-            if (rage_active && !graphics_are_ascii())
-            {
-                feat = FEAT_RAGE_FLOOR;
-            }
-
-            /* Get the floor feature */
-            f_ptr = &f_info[feat];
-
-            /* Normal attr */
-            a = f_ptr->x_attr;
-
-            /* Normal char */
-            c = f_ptr->x_char;
+        u32b key = map_glyph_stamp(feat, info, cave_light[y][x], rage_active);
 
-            /* Skip special light for the player tile. */
-            special_lighting_floor(&a, &c, info, cave_light[y][x]);
+        /* Reuse the glyph if nothing it depends on has changed */
+        if (map_glyph_key[y][x] == key)
+        {
+            a = map_glyph_a[y][x];
+            c = map_glyph_c[y][x];
         }
-
-        /* Unknown */
         else
         {
-            /* Get the darkness feature */
-            f_ptr = &f_info[FEAT_NONE];
+            map_terrain(y, x, feat, info, rage_active, &a, &c);
 
-            /* Normal attr */
-            a = f_ptr->x_attr;
-
-            /* Normal char */
-            c = f_ptr->x_char;
+            map_glyph_key[y][x] = key;
+            map_glyph_a[y][x] = a;
+            map_glyph_c[y][x] = c;
         }
-    }
 
-    /* Interesting grids (non-floors) */
-    else
-    {
-        /* Memorized grids */
-        if (info & (CAVE_MARK))
-        {
-            /* Apply "mimic" field */
+        /* Apply "mimic" field (as the objects below depend on it) */
+        if (!cave_floorlike_bold(y, x) && (info & (CAVE_MARK)))
             feat = f_info[feat].mimic;
-
-            if (rage_active && !graphics_are_ascii()
-                && (feat >= FEAT_WALL_HEAD && feat <= FEAT_WALL_TAIL))
-            {
-                feat = FEAT_RAGE_WALL;
-            }
-
-            /* Get the feature */
-            f_ptr = &f_info[feat];
-
-            /* Normal attr */
-            a = f_ptr->x_attr;
-
-            /* Normal char */
-            c = f_ptr->x_char;
-
-            /* Special lighting effects (walls only) */
-            special_lighting_wall(&a, &c, feat, info);
-        }
-
-        /* Unknown */
-        else
-        {
-            /* Get the darkness feature */
-            f_ptr = &f_info[FEAT_NONE];
-
-            /* Normal attr */
-            a = f_ptr->x_attr;
-
-            /* Normal char */
-            c = f_ptr->x_char;
-        }
     }
 
     /* Save the terrain info for the transparency effects */
@@ -2852,6 +3047,8 @@ void update_view(void)
 
     bool in_pit = cave_pit_bold(p_ptr->py, p_ptr->px) && !p_ptr->leaping;
 
+    PROF_ENTER(PROF_UPDATE_VIEW);
+
     /*** Step 0 -- Begin ***/
 
     /* Save the old "view" grids for later */
@@ -3589,6 +3786,8 @@ void update_view(void)
 
     /* Save 'view_n' */
     view_n = fast_view_n;
+
+    PROF_LEAVE(PROF_UPDATE_VIEW);
 }
 
 /*
@@ -3607,34 +3806,598 @@ int flow_dist(int which_flow, int y, int x)
 }
 
 /*
- * Sil needs various 'flows', which are arrays of the same size as the map,
- * with a number for each map square.
- *
- * One of these flows is used to represent the from the player noise at each
- * location. Another is used to represent the noise from a particular monster.
- *
- * 200 of them are used for alert monster pathfinding, representing the shortest
- * route each monster could take to get to the player.
- *
- * 100 of them are used for the pathfinding of unwary monsters who move in their
- * initial groups to various locations around the map.
- *
- * There is an intermediate data-structure called the flow table, which is
- * 3-dimensional. The first dimension allows the table to both store and
- * overwrite grids safely.  The second indicates whether this value is that for
- * x or for y.  The third is the number of grids able to be stored at any flow
- * distance.
- *
- * Note that the noise is generated around the centre cy, cx
- * This is often the player, but can be a monster (for FLOW_MONSTER_NOISE)
+ * Bookkeeping for the incremental repair of the two noise flows.
  *
+ * A noise flow only depends on its centre and on the terrain, so while
+ * neither changes there is nothing to recompute.  When a few grids of
+ * terrain change (a door is opened or a wall is tunnelled), only the part
+ * of the flow that depended on those grids is repaired.
  */
+static bool noise_flow_valid[2];
+static int noise_flow_dirty_n[2];
+static byte noise_flow_dirty_y[2][FLOW_DIRTY_MAX];
+static byte noise_flow_dirty_x[2][FLOW_DIRTY_MAX];
 
-void update_flow(int cy, int cx, int which_flow)
+/*
+ * Scratch space for the repairs
+ */
+static u16b flow_mark[MAX_DUNGEON_HGT][MAX_DUNGEON_WID];
+static u16b flow_mark_stamp = 0;
+static byte flow_list_y[FLOW_REPAIR_MAX];
+static byte flow_list_x[FLOW_REPAIR_MAX];
+static byte flow_queue_y[FLOW_REPAIR_MAX];
+static byte flow_queue_x[FLOW_REPAIR_MAX];
+static s16b flow_queue_next[FLOW_REPAIR_MAX];
+static s16b flow_queue_head[FLOW_MAX_DIST];
+
+/*
+ * Is this one of the noise flows?
+ */
+static bool noise_flow(int which_flow)
 {
-    int cost;
+    return ((which_flow == FLOW_PLAYER_NOISE)
+        || (which_flow == FLOW_MONSTER_NOISE));
+}
 
-    int i, d;
+/*
+ * The cost for noise to enter a grid, or 0 if it can't.
+ *
+ * Walls (other than secret doors) block noise, and doors muffle it.
+ */
+static int flow_noise_cost(int y, int x)
+{
+    /* Ignore walls */
+    if (cave_wall_bold(y, x) && (cave_feat[y][x] != FEAT_SECRET))
+        return (0);
+
+    /* Penalize doors by 5 */
+    if (cave_any_closed_door_bold(y, x))
+        return (6);
+
+    return (1);
+}
+
+/*
+ * Forget the incremental state of the noise flows.
+ *
+ * This must be called whenever the whole map changes (a new level is made
+ * or loaded) or terrain is changed without using "cave_set_feat()".
+ */
+void forget_flows(void)
+{
+    int i;
+
+    for (i = 0; i < 2; i++)
+    {
+        noise_flow_valid[i] = FALSE;
+        noise_flow_dirty_n[i] = 0;
+    }
+}
+
+/*
+ * Note that the terrain at a grid has changed in a way that matters to noise.
+ *
+ * The noise flows will be repaired around it when they are next updated.
+ */
+void flow_note_change(int y, int x)
+{
+    int i;
+
+    for (i = 0; i < 2; i++)
+    {
+        /* Nothing to repair */
+        if (!noise_flow_valid[i])
+            continue;
+
+        /* Too many changes -- just rebuild it next time */
+        if (noise_flow_dirty_n[i] == FLOW_DIRTY_MAX)
+        {
+            noise_flow_valid[i] = FALSE;
+            continue;
+        }
+
+        noise_flow_dirty_y[i][noise_flow_dirty_n[i]] = y;
+        noise_flow_dirty_x[i][noise_flow_dirty_n[i]] = x;
+        noise_flow_dirty_n[i]++;
+    }
+}
+
+/*
+ * Start a new set of marks in "flow_mark"
+ */
+static void flow_mark_clear(void)
+{
+    /* Wipe the marks when the stamp wraps */
+    if (++flow_mark_stamp == 0)
+    {
+        (void)C_WIPE(flow_mark, MAX_DUNGEON_HGT * MAX_DUNGEON_WID, u16b);
+        flow_mark_stamp = 1;
+    }
+}
+
+/*
+ * Work out the stored value of a noise flow grid that is out of range.
+ *
+ * "update_flow()" only spreads from grids closer than FLOW_MAX_DIST.  A grid
+ * first reached at or beyond that distance is written again by every later
+ * neighbour, so it is left holding the value from its most distant
+ * in-range neighbour.  Grids not reached at all hold FLOW_MAX_DIST.
+ */
+static byte flow_noise_fringe(int which_flow, int y, int x)
+{
+    int d, cost;
+    int best = -1;
+
+    cost = flow_noise_cost(y, x);
+    if (!cost)
+        return (FLOW_MAX_DIST);
+
+    for (d = 0; d < 8; d++)
+    {
+        int y2 = y + ddy_ddd[d];
+        int x2 = x + ddx_ddd[d];
+
+        if (!in_bounds(y2, x2))
+            continue;
+
+        if ((cave_cost[which_flow][y2][x2] < FLOW_MAX_DIST)
+            && (cave_cost[which_flow][y2][x2] > best))
+        {
+            best = cave_cost[which_flow][y2][x2];
+        }
+    }
+
+    if (best < 0)
+        return (FLOW_MAX_DIST);
+
+    return ((byte)(best + cost));
+}
+
+/*
+ * Is a noise flow grid still justified by an in-range neighbour which is
+ * not itself being repaired?
+ */
+static bool flow_noise_supported(int which_flow, int y, int x)
+{
+    int d;
+    int want = cave_cost[which_flow][y][x] - flow_noise_cost(y, x);
+
+    for (d = 0; d < 8; d++)
+    {
+        int y2 = y + ddy_ddd[d];
+        int x2 = x + ddx_ddd[d];
+
+        if (!in_bounds(y2, x2))
+            continue;
+        if (flow_mark[y2][x2] == flow_mark_stamp)
+            continue;
+
+        if (cave_cost[which_flow][y2][x2] == want)
+            return (TRUE);
+    }
+
+    return (FALSE);
+}
+
+/*
+ * Add a grid to the repair queue at the given distance
+ */
+static bool flow_queue_push(int* n, int y, int x, int dist)
+{
+    if (*n >= FLOW_REPAIR_MAX)
+        return (FALSE);
+
+    flow_queue_y[*n] = y;
+    flow_queue_x[*n] = x;
+    flow_queue_next[*n] = flow_queue_head[dist];
+    flow_queue_head[dist] = *n;
+    (*n)++;
+
+    return (TRUE);
+}
+
+/*
+ * Repair a noise flow after some grids of terrain have changed.
+ *
+ * The flow holds shortest distances where entering a grid costs its
+ * "flow_noise_cost()".  First every grid whose distance may have relied on
+ * a changed grid is found and forgotten, then the distances are spread
+ * back into that region (and out from any grid that got cheaper) in order
+ * of distance, and finally the out-of-range values bordering everything
+ * that changed are recomputed.  Returns FALSE if the repair grew too large,
+ * in which case the flow must be rebuilt from scratch.
+ */
+static bool repair_noise_flow(int which_flow)
+{
+    int i, d, dist;
+    int n = 0, n_changed;
+    int queued = 0;
+    int k = which_flow - (FLOW_PLAYER_NOISE);
+    int cy = flow_center_y[which_flow];
+    int cx = flow_center_x[which_flow];
+
+    flow_mark_clear();
+
+    /* Start with the changed grids themselves */
+    for (i = 0; i < noise_flow_dirty_n[k]; i++)
+    {
+        int y = noise_flow_dirty_y[k][i];
+        int x = noise_flow_dirty_x[k][i];
+
+        if ((y == cy) && (x == cx))
+            continue;
+        if (flow_mark[y][x] == flow_mark_stamp)
+            continue;
+
+        flow_mark[y][x] = flow_mark_stamp;
+        flow_list_y[n] = y;
+        flow_list_x[n] = x;
+        n++;
+    }
+
+    /* Find every grid that has lost the neighbour its distance came from */
+    for (i = 0; i < n; i++)
+    {
+        for (d = 0; d < 8; d++)
+        {
+            int y2 = flow_list_y[i] + ddy_ddd[d];
+            int x2 = flow_list_x[i] + ddx_ddd[d];
+
+            if (!in_bounds(y2, x2))
+                continue;
+            if ((y2 == cy) && (x2 == cx))
+                continue;
+            if (flow_mark[y2][x2] == flow_mark_stamp)
+                continue;
+            if (cave_cost[which_flow][y2][x2] >= FLOW_MAX_DIST)
+                continue;
+
+            if (!flow_noise_supported(which_flow, y2, x2))
+            {
+                /* Too much has changed */
+                if (n == FLOW_REPAIR_MAX)
+                    return (FALSE);
+
+                flow_mark[y2][x2] = flow_mark_stamp;
+                flow_list_y[n] = y2;
+                flow_list_x[n] = x2;
+                n++;
+            }
+        }
+    }
+
+    /* Forget them */
+    for (i = 0; i < n; i++)
+    {
+        cave_cost[which_flow][flow_list_y[i]][flow_list_x[i]] = FLOW_MAX_DIST;
+    }
+
+    for (dist = 0; dist < FLOW_MAX_DIST; dist++)
+        flow_queue_head[dist] = -1;
+
+    /* Seed them from their untouched neighbours */
+    for (i = 0; i < n; i++)
+    {
+        int y = flow_list_y[i];
+        int x = flow_list_x[i];
+        int cost = flow_noise_cost(y, x);
+        int best = FLOW_MAX_DIST;
+
+        if (!cost)
+            continue;
+
+        for (d = 0; d < 8; d++)
+        {
+            int y2 = y + ddy_ddd[d];
+            int x2 = x + ddx_ddd[d];
+
+            if (!in_bounds(y2, x2))
+                continue;
+
+            if (cave_cost[which_flow][y2][x2] + cost < best)
+                best = cave_cost[which_flow][y2][x2] + cost;
+        }
+
+        if (best < FLOW_MAX_DIST)
+        {
+            cave_cost[which_flow][y][x] = best;
+            if (!flow_queue_push(&queued, y, x, best))
+                return (FALSE);
+        }
+    }
+
+    n_changed = n;
+
+    /* Spread the distances outwards, nearest first */
+    for (dist = 0; dist < FLOW_MAX_DIST; dist++)
+    {
+        while (flow_queue_head[dist] >= 0)
+        {
+            int q = flow_queue_head[dist];
+            int y = flow_queue_y[q];
+            int x = flow_queue_x[q];
+
+            flow_queue_head[dist] = flow_queue_next[q];
+
+            /* Skip stale entries */
+            if (cave_cost[which_flow][y][x] != dist)
+                continue;
+
+            for (d = 0; d < 8; d++)
+            {
+                int y2 = y + ddy_ddd[d];
+                int x2 = x + ddx_ddd[d];
+                int cost, new_dist;
+
+                if (!in_bounds(y2, x2))
+                    continue;
+                if ((y2 == cy) && (x2 == cx))
+                    continue;
+
+                cost = flow_noise_cost(y2, x2);
+                if (!cost)
+                    continue;
+
+                new_dist = dist + cost;
+
+                if ((new_dist >= FLOW_MAX_DIST)
+                    || (new_dist >= cave_cost[which_flow][y2][x2]))
+                    continue;
+
+                cave_cost[which_flow][y2][x2] = new_dist;
+                if (!flow_queue_push(&queued, y2, x2, new_dist))
+                    return (FALSE);
+
+                /* Remember grids outside the region that got closer */
+                if (flow_mark[y2][x2] != flow_mark_stamp)
+                {
+                    if (n_changed == FLOW_REPAIR_MAX)
+                        return (FALSE);
+
+                    flow_mark[y2][x2] = flow_mark_stamp;
+                    flow_list_y[n_changed] = y2;
+                    flow_list_x[n_changed] = x2;
+                    n_changed++;
+                }
+            }
+        }
+    }
+
+    /* Recompute the out-of-range values next to anything that changed */
+    for (i = 0; i < n_changed; i++)
+    {
+        for (d = 0; d < 9; d++)
+        {
+            int y2 = flow_list_y[i] + ddy_ddd[d];
+            int x2 = flow_list_x[i] + ddx_ddd[d];
+
+            if (!in_bounds(y2, x2))
+                continue;
+            if ((y2 == cy) && (x2 == cx))
+                continue;
+            if (cave_cost[which_flow][y2][x2] < FLOW_MAX_DIST)
+                continue;
+
+            cave_cost[which_flow][y2][x2]
+                = flow_noise_fringe(which_flow, y2, x2);
+        }
+    }
+
+    return (TRUE);
+}
+
+/*
+ * Make the monsters reached by a noise flow re-consider their targets,
+ * just as rebuilding the flow in "update_flow()" does.
+ *
+ * A monster's grid is reached if noise can enter it and it is next to a
+ * grid from which the noise spreads.
+ */
+static void flow_noise_retarget(int which_flow)
+{
+    int i, d;
+    int cy = flow_center_y[which_flow];
+    int cx = flow_center_x[which_flow];
+
+    for (i = 1; i < mon_max; i++)
+    {
+        monster_type* m_ptr = &mon_list[i];
+        int y = m_ptr->fy;
+        int x = m_ptr->fx;
+
+        /* Skip dead monsters */
+        if (!m_ptr->r_idx)
+            continue;
+
+        if ((y == cy) && (x == cx))
+            continue;
+        if (!flow_noise_cost(y, x))
+            continue;
+
+        for (d = 0; d < 8; d++)
+        {
+            int y2 = y + ddy_ddd[d];
+            int x2 = x + ddx_ddd[d];
+
+            if (!in_bounds(y2, x2))
+                continue;
+
+            if (cave_cost[which_flow][y2][x2] < FLOW_MAX_DIST)
+            {
+                m_ptr->target_x = 0;
+                m_ptr->target_y = 0;
+                break;
+            }
+        }
+    }
+}
+
+/*
+ * The flow pool.
+ *
+ * A level only uses a handful of its MAX_FLOWS flows at once, so a flow is
+ * only given a grid of its own when it is first built.  Until then (and
+ * once it has been released) it shares "flow_blank", in which nothing has
+ * been reached.  Released grids are reused least recently released first.
+ */
+static byte_wid flow_blank[MAX_DUNGEON_HGT];
+static byte_wid* flow_grid[MAX_FLOWS];
+static int flow_grid_n = 0;
+static s16b flow_slot[MAX_FLOWS];
+static s16b flow_free[MAX_FLOWS];
+static int flow_free_head = 0;
+static int flow_free_n = 0;
+
+/*
+ * Set up the flow pool, with every flow unbuilt
+ */
+void init_flows(void)
+{
+    int i;
+
+    /* Free any grids from a previous game */
+    cleanup_flows();
+
+    (void)memset(flow_blank, FLOW_MAX_DIST, sizeof(flow_blank));
+
+    for (i = 0; i < MAX_FLOWS; i++)
+    {
+        cave_cost[i] = flow_blank;
+        flow_slot[i] = -1;
+    }
+}
+
+/*
+ * Free all the grids in the flow pool
+ */
+void cleanup_flows(void)
+{
+    int i;
+
+    for (i = 0; i < flow_grid_n; i++)
+    {
+        FREE(flow_grid[i]);
+    }
+
+    flow_grid_n = 0;
+    flow_free_head = 0;
+    flow_free_n = 0;
+}
+
+/*
+ * Give a flow's grid back to the pool.
+ *
+ * Called when the owner of a monster flow dies.
+ */
+void flow_release(int which_flow)
+{
+    int g = flow_slot[which_flow];
+
+    if (g < 0)
+        return;
+
+    flow_free[(flow_free_head + flow_free_n) % (MAX_FLOWS)] = g;
+    flow_free_n++;
+
+    flow_slot[which_flow] = -1;
+    cave_cost[which_flow] = flow_blank;
+}
+
+/*
+ * Give every flow's grid back to the pool (for a new level)
+ */
+void wipe_flows(void)
+{
+    int i;
+
+    for (i = 0; i < MAX_FLOWS; i++)
+    {
+        flow_release(i);
+    }
+
+    /* The noise flows must be rebuilt from scratch */
+    forget_flows();
+}
+
+/*
+ * Hand a flow's grid over to another flow (when a monster is moved in the
+ * monster list)
+ */
+void flow_move(int from, int to)
+{
+    flow_release(to);
+
+    flow_slot[to] = flow_slot[from];
+    cave_cost[to] = cave_cost[from];
+
+    flow_slot[from] = -1;
+    cave_cost[from] = flow_blank;
+}
+
+/*
+ * Make sure that a flow has a grid of its own to be built in
+ */
+static void flow_claim(int which_flow)
+{
+    int g;
+
+    if (flow_slot[which_flow] >= 0)
+        return;
+
+    /* Reuse the grid that has been free the longest */
+    if (flow_free_n)
+    {
+        g = flow_free[flow_free_head];
+        flow_free_head = (flow_free_head + 1) % (MAX_FLOWS);
+        flow_free_n--;
+    }
+
+    /* Or make a new one */
+    else
+    {
+        g = flow_grid_n++;
+        C_MAKE(flow_grid[g], MAX_DUNGEON_HGT, byte_wid);
+    }
+
+    /* Nothing has been reached yet */
+    (void)memset(flow_grid[g], FLOW_MAX_DIST, sizeof(flow_blank));
+
+    flow_slot[which_flow] = g;
+    cave_cost[which_flow] = flow_grid[g];
+}
+
+/*
+ * Sil needs various 'flows', which are arrays of the same size as the map,
+ * with a number for each map square.
+ *
+ * One of these flows is used to represent the from the player noise at each
+ * location. Another is used to represent the noise from a particular monster.
+ *
+ * 200 of them are used for alert monster pathfinding, representing the shortest
+ * route each monster could take to get to the player.
+ *
+ * 100 of them are used for the pathfinding of unwary monsters who move in their
+ * initial groups to various locations around the map.
+ *
+ * There is an intermediate data-structure called the flow table, which is
+ * 3-dimensional. The first dimension allows the table to both store and
+ * overwrite grids safely.  The second indicates whether this value is that for
+ * x or for y.  The third is the number of grids able to be stored at any flow
+ * distance.
+ *
+ * Note that the noise is generated around the centre cy, cx
+ * This is often the player, but can be a monster (for FLOW_MONSTER_NOISE)
+ *
+ * The noise flows are not rebuilt if their centre hasn't moved, and are
+ * only repaired around the changed grids if a little terrain has changed
+ * (see "repair_noise_flow()").  The result is the same either way.
+ */
+
+void update_flow(int cy, int cx, int which_flow)
+{
+    int cost;
+
+    int i, d;
     byte y, x, y2, x2;
     int last_index;
     int grid_count = 0;
@@ -3652,6 +4415,8 @@ void update_flow(int cy, int cx, int which_flow)
 
     byte flow_table[2][2][8 * FLOW_MAX_DIST];
 
+    PROF_ENTER(PROF_UPDATE_FLOW);
+
     // pull out the relevant monster info for the monster flows
     if (which_flow < MAX_MONSTERS)
     {
@@ -3688,9 +4453,38 @@ void update_flow(int cy, int cx, int which_flow)
         // stop if this is just a vestigial flow left after the monsters died
         // (these are attempted to be reprocessed on save game load)
         if (!found)
+        {
+            PROF_LEAVE(PROF_UPDATE_FLOW);
+            return;
+        }
+    }
+
+    /* Noise flows that are already up to date only need to be repaired */
+    else if (noise_flow(which_flow))
+    {
+        int k = which_flow - (FLOW_PLAYER_NOISE);
+
+        if (noise_flow_valid[k] && (flow_center_y[which_flow] == cy)
+            && (flow_center_x[which_flow] == cx)
+            && (!noise_flow_dirty_n[k] || repair_noise_flow(which_flow)))
+        {
+            noise_flow_dirty_n[k] = 0;
+
+            /* Monsters within reach re-consider their targets */
+            flow_noise_retarget(which_flow);
+
+            PROF_LEAVE(PROF_UPDATE_FLOW);
             return;
+        }
+
+        /* The flow is about to be rebuilt from scratch */
+        noise_flow_valid[k] = TRUE;
+        noise_flow_dirty_n[k] = 0;
     }
 
+    /* Get a grid to build the flow in */
+    flow_claim(which_flow);
+
     /* Save the new flow epicenter */
     flow_center_y[which_flow] = cy;
     flow_center_x[which_flow] = cx;
@@ -3828,16 +4622,14 @@ void update_flow(int cy, int cx, int which_flow)
                     // Deal with noise flows
                     else
                     {
+                        int noise_cost = flow_noise_cost(y2, x2);
+
                         // ignore walls
-                        if (cave_wall_bold(y2, x2)
-                            && (cave_feat[y2][x2] != FEAT_SECRET))
+                        if (!noise_cost)
                             continue;
 
-                        // penalize doors by 5 when calculating the real noise
-                        if (cave_any_closed_door_bold(y2, x2))
-                        {
-                            extra_cost += 5;
-                        }
+                        // penalize doors when calculating the real noise
+                        extra_cost += noise_cost - 1;
                     }
 
                     /* Monsters at this site need to re-consider their targets
@@ -3876,6 +4668,144 @@ void update_flow(int cy, int cx, int which_flow)
             next_cycle = 1;
         }
     }
+
+    PROF_LEAVE(PROF_UPDATE_FLOW);
+}
+
+/*
+ * Grid kernels.
+ *
+ * Passes over the whole map are done a row at a time by these, which work
+ * on 8 or 16 grids at once with SSE2 where it is available.  A "selection"
+ * row holds 0xFF for the grids to be affected and 0 for the others.
+ */
+
+/*
+ * Scratch selections for the grid kernels
+ */
+static byte grid_sel[MAX_DUNGEON_HGT][MAX_DUNGEON_WID];
+static byte grid_row_sel[MAX_DUNGEON_WID];
+
+/*
+ * Age a row of scent for "update_smell()".
+ *
+ * The earlier part of the previous cycle is erased, and the most recent
+ * scent is moved to the end of the new cycle.
+ */
+static void grid_row_age(byte* row, int n)
+{
+    int x = 0;
+
+#ifdef GRID_SSE2
+    __m128i zero = _mm_setzero_si128();
+    __m128i strength = _mm_set1_epi8((char)SMELL_STRENGTH);
+    __m128i shift = _mm_set1_epi8((char)(250 - SMELL_STRENGTH));
+
+    for (; x + 16 <= n; x += 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(row + x));
+        __m128i recent = _mm_cmpeq_epi8(_mm_min_epu8(v, strength), v);
+        __m128i keep = _mm_andnot_si128(_mm_cmpeq_epi8(v, zero), recent);
+
+        _mm_storeu_si128(
+            (__m128i*)(row + x), _mm_and_si128(keep, _mm_add_epi8(v, shift)));
+    }
+#endif
+
+    for (; x < n; x++)
+    {
+        if ((row[x] == 0) || (row[x] > SMELL_STRENGTH))
+            row[x] = 0;
+        else
+            row[x] = 250 - SMELL_STRENGTH + row[x];
+    }
+}
+
+/*
+ * Add a selection, and the grids on either side of it, to another one
+ */
+static void grid_row_spread(byte* dst, const byte* src, int n)
+{
+    int x;
+
+    if (n < 2)
+    {
+        if (n == 1)
+            dst[0] |= src[0];
+        return;
+    }
+
+    dst[0] |= src[0] | src[1];
+
+    x = 1;
+
+#ifdef GRID_SSE2
+    for (; x + 17 <= n; x += 16)
+    {
+        __m128i l = _mm_loadu_si128((const __m128i*)(src + x - 1));
+        __m128i m = _mm_loadu_si128((const __m128i*)(src + x));
+        __m128i r = _mm_loadu_si128((const __m128i*)(src + x + 1));
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + x));
+
+        d = _mm_or_si128(d, _mm_or_si128(l, _mm_or_si128(m, r)));
+        _mm_storeu_si128((__m128i*)(dst + x), d);
+    }
+#endif
+
+    for (; x < n - 1; x++)
+    {
+        dst[x] |= src[x - 1] | src[x] | src[x + 1];
+    }
+
+    dst[n - 1] |= src[n - 2] | src[n - 1];
+}
+
+/*
+ * Set and clear some "cave_info" flags in the selected grids of a row.
+ *
+ * A NULL selection selects the whole row.
+ */
+static void grid_row_mark(u16b* info, const byte* sel, int n, u16b set,
+    u16b clear)
+{
+    int x = 0;
+
+    if (!sel)
+    {
+        for (x = 0; x < n; x++)
+        {
+            info[x] = (info[x] & ~clear) | set;
+        }
+
+        return;
+    }
+
+#ifdef GRID_SSE2
+    {
+        __m128i s = _mm_set1_epi16((short)set);
+        __m128i c = _mm_set1_epi16((short)clear);
+
+        for (; x + 8 <= n; x += 8)
+        {
+            __m128i m = _mm_loadl_epi64((const __m128i*)(sel + x));
+            __m128i v = _mm_loadu_si128((const __m128i*)(info + x));
+
+            /* Widen the selection to 16 bits per grid */
+            m = _mm_unpacklo_epi8(m, m);
+
+            v = _mm_andnot_si128(_mm_and_si128(m, c), v);
+            v = _mm_or_si128(v, _mm_and_si128(m, s));
+            _mm_storeu_si128((__m128i*)(info + x), v);
+        }
+    }
+#endif
+
+    for (; x < n; x++)
+    {
+        u16b m = (u16b)(sel[x] * 0x0101);
+
+        info[x] = (info[x] & ~(clear & m)) | (set & m);
+    }
 }
 
 /*
@@ -3917,20 +4847,9 @@ void update_smell(void)
         /* Scan the entire dungeon */
         for (y = 0; y < p_ptr->cur_map_hgt; y++)
         {
-            for (x = 0; x < p_ptr->cur_map_wid; x++)
-            {
-                /* Ignore non-existent scent */
-                if (cave_when[y][x] == 0)
-                    continue;
-
-                /* Erase the earlier part of the previous cycle */
-                if (cave_when[y][x] > SMELL_STRENGTH)
-                    cave_when[y][x] = 0;
-
-                /* Reset the ages of the most recent scent */
-                else
-                    cave_when[y][x] = 250 - SMELL_STRENGTH + cave_when[y][x];
-            }
+            /* Erase the earlier part of the previous cycle, and reset the
+             * ages of the most recent scent */
+            grid_row_age(cave_when[y], p_ptr->cur_map_wid);
         }
 
         /* Reset the age value */
@@ -3969,6 +4888,26 @@ void update_smell(void)
     }
 }
 
+/*
+ * Magic mapping looks at all non-walls, including rubble
+ */
+static bool map_checked_bold(int y, int x)
+{
+    return ((cave_feat[y][x] < FEAT_WALL_HEAD) || (cave_stair_bold(y, x))
+        || (cave_feat[y][x] == FEAT_RUBBLE) || cave_forge_bold(y, x)
+        || (cave_feat[y][x] == FEAT_CHASM));
+}
+
+/*
+ * Magic mapping memorizes the normal features that it looks at
+ */
+static bool map_memorable_bold(int y, int x)
+{
+    return ((cave_feat[y][x] >= FEAT_DOOR_HEAD) || (cave_stair_bold(y, x))
+        || (cave_feat[y][x] == FEAT_RUBBLE) || cave_forge_bold(y, x)
+        || (cave_feat[y][x] == FEAT_CHASM));
+}
+
 void map_feature(int y, int x)
 {
     int i;
@@ -3977,14 +4916,10 @@ void map_feature(int y, int x)
         return;
 
     /* All non-walls are "checked", including rubble */
-    if ((cave_feat[y][x] < FEAT_WALL_HEAD) || (cave_stair_bold(y, x))
-        || (cave_feat[y][x] == FEAT_RUBBLE) || cave_forge_bold(y, x)
-        || (cave_feat[y][x] == FEAT_CHASM))
+    if (map_checked_bold(y, x))
     {
         /* Memorize normal features */
-        if ((cave_feat[y][x] >= FEAT_DOOR_HEAD) || (cave_stair_bold(y, x))
-            || (cave_feat[y][x] == FEAT_RUBBLE) || cave_forge_bold(y, x)
-            || (cave_feat[y][x] == FEAT_CHASM))
+        if (map_memorable_bold(y, x))
         {
             /* Memorize the feature */
             cave_info[y][x] |= (CAVE_MARK);
@@ -4015,14 +4950,40 @@ void map_feature(int y, int x)
 void map_area(void)
 {
     int x, y;
+    int hgt = p_ptr->cur_map_hgt;
+    int wid = p_ptr->cur_map_wid;
+
+    (void)C_WIPE(grid_sel, MAX_DUNGEON_HGT, byte_wid);
+    (void)C_WIPE(grid_row_sel, MAX_DUNGEON_WID, byte);
+
+    /* Scan that area (as "map_feature()" does for each grid) */
+    for (y = 1; y < hgt - 1; y++)
+    {
+        for (x = 1; x < wid - 1; x++)
+        {
+            /* All non-walls are "checked", including rubble */
+            grid_row_sel[x] = map_checked_bold(y, x) ? 0xFF : 0;
+
+            /* Memorize normal features */
+            if (grid_row_sel[x] && map_memorable_bold(y, x))
+                cave_info[y][x] |= (CAVE_MARK);
+        }
 
-    /* Scan that area */
-    for (y = 1; y < MAX_DUNGEON_HGT; y++)
+        /* Note their neighbours */
+        grid_row_spread(grid_sel[y - 1], grid_row_sel, wid);
+        grid_row_spread(grid_sel[y], grid_row_sel, wid);
+        grid_row_spread(grid_sel[y + 1], grid_row_sel, wid);
+    }
+
+    /* Memorize walls next to the checked grids */
+    for (y = 0; y < hgt; y++)
     {
-        for (x = 1; x < MAX_DUNGEON_WID; x++)
+        for (x = 0; x < wid; x++)
         {
-            map_feature(y, x);
+            grid_row_sel[x] = cave_wall_bold(y, x) ? grid_sel[y][x] : 0;
         }
+
+        grid_row_mark(cave_info[y], grid_row_sel, wid, CAVE_MARK, 0);
     }
 
     /* Redraw map */
@@ -4042,6 +5003,8 @@ void map_area(void)
 void wiz_light(void)
 {
     int i, y, x;
+    int hgt = p_ptr->cur_map_hgt;
+    int wid = p_ptr->cur_map_wid;
 
     /* Memorize objects */
     for (i = 1; i < o_max; i++)
@@ -4060,29 +5023,33 @@ void wiz_light(void)
         o_ptr->marked = TRUE;
     }
 
+    (void)C_WIPE(grid_sel, MAX_DUNGEON_HGT, byte_wid);
+    (void)C_WIPE(grid_row_sel, MAX_DUNGEON_WID, byte);
+
     /* Scan all normal grids */
-    for (y = 1; y < p_ptr->cur_map_hgt - 1; y++)
+    for (y = 1; y < hgt - 1; y++)
     {
         /* Scan all normal grids */
-        for (x = 1; x < p_ptr->cur_map_wid - 1; x++)
+        for (x = 1; x < wid - 1; x++)
         {
             /* Process all non-walls, but don't count rubble */
-            if ((!cave_wall_bold(y, x)) || (cave_feat[y][x] == FEAT_RUBBLE))
-            {
-                /* Scan all neighbors */
-                for (i = 0; i < 9; i++)
-                {
-                    int yy = y + ddy_ddd[i];
-                    int xx = x + ddx_ddd[i];
+            grid_row_sel[x]
+                = ((!cave_wall_bold(y, x)) || (cave_feat[y][x] == FEAT_RUBBLE))
+                ? 0xFF
+                : 0;
+        }
 
-                    /* Perma-lite the grid */
-                    cave_info[yy][xx] |= (CAVE_GLOW);
+        /* Select all neighbors */
+        grid_row_spread(grid_sel[y - 1], grid_row_sel, wid);
+        grid_row_spread(grid_sel[y], grid_row_sel, wid);
+        grid_row_spread(grid_sel[y + 1], grid_row_sel, wid);
+    }
 
-                    /* Remember the grid */
-                    cave_info[yy][xx] |= (CAVE_MARK);
-                }
-            }
-        }
+    /* Perma-lite and remember the selected grids */
+    for (y = 0; y < hgt; y++)
+    {
+        grid_row_mark(
+            cave_info[y], grid_sel[y], wid, (CAVE_GLOW | CAVE_MARK), 0);
     }
 
     /* Fully update the visuals */
@@ -4101,21 +5068,25 @@ void wiz_light(void)
 void wiz_dark(void)
 {
     int i, y, x;
+    int wid = p_ptr->cur_map_wid;
 
     /* Forget every grid */
     for (y = 0; y < p_ptr->cur_map_hgt; y++)
     {
-        for (x = 0; x < p_ptr->cur_map_wid; x++)
-        {
-            /* Process the grid */
-            cave_info[y][x] &= ~(CAVE_MARK);
+        /* Process the row */
+        grid_row_mark(cave_info[y], NULL, wid, 0, CAVE_MARK);
 
-            // forget all traps!
-            if (cave_trap_bold(y, x) && !((p_ptr->py == y) && (p_ptr->px == x)))
-            {
-                cave_info[y][x] |= (CAVE_HIDDEN);
-            }
+        // forget all traps!
+        for (x = 0; x < wid; x++)
+        {
+            grid_row_sel[x] = cave_trap_bold(y, x) ? 0xFF : 0;
         }
+
+        // ...except the one the player is on
+        if ((p_ptr->py == y) && (p_ptr->px >= 0) && (p_ptr->px < wid))
+            grid_row_sel[p_ptr->px] = 0;
+
+        grid_row_mark(cave_info[y], grid_row_sel, wid, CAVE_HIDDEN, 0);
     }
 
     /* Forget all objects */
@@ -4168,41 +5139,33 @@ void wiz_dark(void)
 void gates_illuminate(bool daytime)
 {
     int y, x;
+    int wid = p_ptr->cur_map_wid;
 
     /* Apply light or darkness */
     for (y = 0; y < p_ptr->cur_map_hgt; y++)
     {
-        for (x = 0; x < p_ptr->cur_map_wid; x++)
+        /* Select the interesting grids, and the boring ones by day */
+        for (x = 0; x < wid; x++)
         {
-            /* Interesting grids */
-            if (!cave_floorlike_bold(y, x))
-            {
-                /* Illuminate the grid */
-                cave_info[y][x] |= (CAVE_GLOW);
+            grid_row_sel[x]
+                = (daytime || !cave_floorlike_bold(y, x)) ? 0xFF : 0;
+        }
 
-                /* Memorize the grid */
-                cave_info[y][x] |= (CAVE_MARK);
-            }
+        /* Illuminate and memorize them */
+        grid_row_mark(
+            cave_info[y], grid_row_sel, wid, (CAVE_GLOW | CAVE_MARK), 0);
 
-            /* Boring grids (light) */
-            else if (daytime)
+        /* Boring grids (dark) */
+        if (!daytime)
+        {
+            for (x = 0; x < wid; x++)
             {
-                /* Illuminate the grid */
-                cave_info[y][x] |= (CAVE_GLOW);
-
-                /* Memorize grids */
-                cave_info[y][x] |= (CAVE_MARK);
+                grid_row_sel[x] = ~grid_row_sel[x];
             }
 
-            /* Boring grids (dark) */
-            else
-            {
-                /* Darken the grid */
-                cave_info[y][x] &= ~(CAVE_GLOW);
-
-                /* Forget grids */
-                cave_info[y][x] &= ~(CAVE_MARK);
-            }
+            /* Darken and forget them */
+            grid_row_mark(
+                cave_info[y], grid_row_sel, wid, 0, (CAVE_GLOW | CAVE_MARK));
         }
     }
 
@@ -4216,14 +5179,176 @@ void gates_illuminate(bool daytime)
     p_ptr->window |= (PW_OVERHEAD | PW_MONLIST);
 }
 
+/*
+ * Allocate an empty level context
+ */
+level_context* level_context_make(void)
+{
+    level_context* lc;
+
+    MAKE(lc, level_context);
+
+    C_MAKE(lc->info, MAX_DUNGEON_HGT, u16b_256);
+    C_MAKE(lc->feat, MAX_DUNGEON_HGT, byte_wid);
+    C_MAKE(lc->light, MAX_DUNGEON_HGT, s16b_wid);
+    C_MAKE(lc->o_idx, MAX_DUNGEON_HGT, s16b_wid);
+    C_MAKE(lc->m_idx, MAX_DUNGEON_HGT, s16b_wid);
+    C_MAKE(lc->when, MAX_DUNGEON_HGT, byte_wid);
+
+    C_MAKE(lc->o_list, z_info->o_max, object_type);
+    C_MAKE(lc->mon_list, MAX_MONSTERS, monster_type);
+
+    lc->o_max = 1;
+    lc->mon_max = 1;
+
+    lc->scent_when = 250;
+
+    return (lc);
+}
+
+/*
+ * Free a level context (which must not be the active one)
+ */
+void level_context_free(level_context* lc)
+{
+    FREE(lc->mon_list);
+    FREE(lc->o_list);
+
+    FREE(lc->when);
+    FREE(lc->m_idx);
+    FREE(lc->o_idx);
+    FREE(lc->light);
+    FREE(lc->feat);
+    FREE(lc->info);
+
+    FREE(lc);
+}
+
+/*
+ * Add "by" to the count of every live monster race on the active level
+ */
+static void level_context_count(int by)
+{
+    int i;
+
+    for (i = 1; i < mon_max; i++)
+    {
+        monster_type* m_ptr = &mon_list[i];
+
+        if (m_ptr->r_idx)
+            r_info[m_ptr->r_idx].cur_num += by;
+    }
+}
+
+/*
+ * Exchange the active level (held in the usual globals) with the one
+ * held in "lc"
+ *
+ * Only the array pointers are exchanged, so this is cheap.  The flows, the
+ * "los()" cache and the view are forgotten and the wandering flows rebuilt,
+ * as when a level is loaded.  The monster race counts follow the monsters,
+ * so the cached monster allocation bands are forgotten.
+ */
+void level_context_swap(level_context* lc)
+{
+    int i;
+
+    char vault_name[80];
+
+    /* Forget the view of the old level */
+    forget_view();
+
+    /* Its monsters are no longer about */
+    level_context_count(-1);
+
+#define LEVEL_SWAP(T, G, F)                                                   \
+    do                                                                         \
+    {                                                                          \
+        T tmp = (G);                                                           \
+        (G) = (lc->F);                                                         \
+        (lc->F) = tmp;                                                         \
+    } while (0)
+
+    LEVEL_SWAP(u16b_256*, cave_info, info);
+    LEVEL_SWAP(byte_wid*, cave_feat, feat);
+    LEVEL_SWAP(s16b_wid*, cave_light, light);
+    LEVEL_SWAP(s16b_wid*, cave_o_idx, o_idx);
+    LEVEL_SWAP(s16b_wid*, cave_m_idx, m_idx);
+    LEVEL_SWAP(byte_wid*, cave_when, when);
+    LEVEL_SWAP(object_type*, o_list, o_list);
+    LEVEL_SWAP(monster_type*, mon_list, mon_list);
+
+    LEVEL_SWAP(s16b, o_max, o_max);
+    LEVEL_SWAP(s16b, o_cnt, o_cnt);
+    LEVEL_SWAP(s16b, mon_max, mon_max);
+    LEVEL_SWAP(s16b, mon_cnt, mon_cnt);
+    LEVEL_SWAP(int, scent_when, scent_when);
+    LEVEL_SWAP(s16b, p_ptr->depth, depth);
+    LEVEL_SWAP(s16b, p_ptr->py, py);
+    LEVEL_SWAP(s16b, p_ptr->px, px);
+    LEVEL_SWAP(byte, p_ptr->cur_map_hgt, cur_map_hgt);
+    LEVEL_SWAP(byte, p_ptr->cur_map_wid, cur_map_wid);
+
+    for (i = 0; i < MAX_WANDERING_GROUPS; i++)
+    {
+        LEVEL_SWAP(byte, flow_center_y[FLOW_WANDERING_HEAD + i],
+            flow_center_y[i]);
+        LEVEL_SWAP(byte, flow_center_x[FLOW_WANDERING_HEAD + i],
+            flow_center_x[i]);
+        LEVEL_SWAP(s16b, wandering_pause[FLOW_WANDERING_HEAD + i],
+            wandering_pause[i]);
+    }
+
+    LEVEL_SWAP(s16b, num_repro, num_repro);
+    LEVEL_SWAP(bool, do_feeling, do_feeling);
+    LEVEL_SWAP(byte, feeling, feeling);
+    LEVEL_SWAP(s16b, rating, rating);
+    LEVEL_SWAP(bool, good_item_flag, good_item_flag);
+
+#undef LEVEL_SWAP
+
+    my_strcpy(vault_name, g_vault_name, sizeof(vault_name));
+    my_strcpy(g_vault_name, lc->vault_name, sizeof(g_vault_name));
+    my_strcpy(lc->vault_name, vault_name, sizeof(lc->vault_name));
+
+    /* The monsters of the new level are about */
+    level_context_count(1);
+
+    /* The race counts have changed (see "get_mon_num()") */
+    alloc_race_stamp++;
+
+    /* No flows */
+    wipe_flows();
+
+    /* Rebuild the wandering flows (as "rd_dungeon()") */
+    for (i = FLOW_WANDERING_HEAD; i <= FLOW_WANDERING_TAIL; i++)
+        update_flow(flow_center_y[i], flow_center_x[i], i);
+
+    /* No remembered lines of sight */
+    los_cache_forget();
+
+    /* Every monster of the new level may be ready to act */
+    mon_ready_reset();
+
+    /* Look around the new level */
+    p_ptr->update |= (PU_UPDATE_VIEW | PU_DISTANCE);
+}
+
 /*
  * Change the "feat" flag for a grid, and notice/redraw the grid
  */
 void cave_set_feat(int y, int x, int feat)
 {
+    int old_noise_cost = flow_noise_cost(y, x);
+    u16b old_wall = cave_info[y][x] & (CAVE_WALL);
+
     /* Change the feature */
     cave_feat[y][x] = feat;
 
+    /* Let the noise flows know if noise now travels differently here */
+    if (flow_noise_cost(y, x) != old_noise_cost)
+        flow_note_change(y, x);
+
     /* Handle "wall/door" grids */
     if (((feat >= FEAT_DOOR_HEAD) && (feat <= FEAT_WALL_TAIL))
         || feat == FEAT_WARDED || feat == FEAT_WARDED2 || feat == FEAT_WARDED3)
@@ -4237,6 +5362,10 @@ void cave_set_feat(int y, int x, int feat)
         cave_info[y][x] &= ~(CAVE_WALL);
     }
 
+    /* Lines of sight through this grid may have changed */
+    if ((cave_info[y][x] & (CAVE_WALL)) != old_wall)
+        los_cache_forget();
+
     /* Notice/Redraw */
     if (character_dungeon)
     {
@@ -6926,6 +6926,12 @@ extern void do_cmd_options_aux(int page, cptr info)
                     "Delay factor for animation (0 to 9)",
                     op_ptr->delay_factor);
             }
+            else if (opt[i] == OPT_frame_budget)
+            {
+                strnfmt(buf, sizeof(buf), "%-48s: %d ms",
+                    "Frame budget for animation (0 is every frame)",
+                    op_ptr->frame_budget * 10);
+            }
             else if (opt[i] == OPT_hitpoint_warning)
             {
                 strnfmt(buf, sizeof(buf), "%-48s: %d%%",
@@ -7037,6 +7043,12 @@ extern void do_cmd_options_aux(int page, cptr info)
                         ? op_ptr->delay_factor + 1
                         : 9;
                 }
+                else if (opt[k] == OPT_frame_budget)
+                {
+                    op_ptr->frame_budget = (op_ptr->frame_budget < 9)
+                        ? op_ptr->frame_budget + 1
+                        : 9;
+                }
                 else if (opt[k] == OPT_hitpoint_warning)
                 {
                     op_ptr->hitpoint_warn = (op_ptr->hitpoint_warn < 9)
@@ -7062,6 +7074,12 @@ extern void do_cmd_options_aux(int page, cptr info)
                         ? op_ptr->delay_factor - 1
                         : 0;
                 }
+                else if (opt[k] == OPT_frame_budget)
+                {
+                    op_ptr->frame_budget = (op_ptr->frame_budget > 0)
+                        ? op_ptr->frame_budget - 1
+                        : 0;
+                }
                 else if (opt[k] == OPT_hitpoint_warning)
                 {
                     op_ptr->hitpoint_warn = (op_ptr->hitpoint_warn > 0)
@@ -8770,6 +8788,9 @@ void do_cmd_visuals(void)
                 {
                     askfor_shade(&f_info[f].x_attr, 22);
                 }
+
+                /* The cached map glyphs are stale */
+                map_info_forget();
             }
         }
 
@@ -9587,6 +9608,9 @@ void do_cmd_note(char* note, int what_depth)
     /* Make preliminary part of note */
     strnfmt(info_note, sizeof(info_note), "%7s  %s   ", turn_string, depths);
 
+    /* The savefile may still hold the earlier notes */
+    load_notes();
+
     /*write the info note*/
     my_strcat(notes_buffer, info_note, sizeof(notes_buffer));
 
@@ -9754,7 +9778,11 @@ void ghost_challenge(void)
 }
 
 /*display the notes file*/
-void do_cmd_knowledge_notes(void) { show_buffer(notes_buffer, "Notes", 0); }
+void do_cmd_knowledge_notes(void)
+{
+    load_notes();
+    show_buffer(notes_buffer, "Notes", 0);
+}
 
 /*
  * Hack -- save a screen dump to a file
@@ -64,6 +64,27 @@
 #define OLD_VERSION_MINOR 5
 #define OLD_VERSION_PATCH 0
 
+/*
+ * Savefiles are split into sections, found through a table at the end
+ * of the file.  The first spare word of the preamble marks such a file,
+ * and the second holds the version of the section layout.
+ */
+#define SF_SECTIONS 0x54434553L
+#define SF_SECTION_VERSION 1
+
+/*
+ * Savefile section types (in the order they are written)
+ */
+#define SF_SECT_OPTIONS 1 /* RNG state and options */
+#define SF_SECT_MESSAGES 2 /* Message recall (loaded on demand) */
+#define SF_SECT_LORE 3 /* Monster lore */
+#define SF_SECT_KNOWLEDGE 4 /* Object memory and artefacts */
+#define SF_SECT_PLAYER 5 /* Player and random artefacts */
+#define SF_SECT_NOTES 6 /* Character notes (loaded on demand) */
+#define SF_SECT_INVEN 7 /* Smithing item and inventory */
+#define SF_SECT_DUNGEON 8 /* Current level (living characters only) */
+#define SF_SECT_MAX 16 /* Most sections in a savefile */
+
 /*
  * Version of random artefact code.
  */
@@ -266,6 +287,15 @@
  */
 #define FLOW_MAX_DIST 250
 
+/*
+ * Noise flows (player and monster noise) are repaired in place when only a
+ * few grids of terrain have changed since they were last built.  These are
+ * the most changed grids remembered per flow, and the most grids a repair
+ * may touch before it gives up and the whole flow is rebuilt instead.
+ */
+#define FLOW_DIRTY_MAX 16
+#define FLOW_REPAIR_MAX 2048
+
 #define BASE_FLOW_CENTER 1
 
 /*
@@ -371,6 +401,17 @@
 #define MAX_SIGHT 20 /* Maximum view distance */
 #define MAX_RANGE 20 /* Maximum range (spells, etc) */
 
+/*
+ * Number of remembered "los()" results (as a power of two)
+ */
+#define LOS_CACHE_BITS 13
+#define LOS_CACHE_SIZE (1 << LOS_CACHE_BITS)
+
+/*
+ * Number of cached bands per allocation table
+ */
+#define ALLOC_BAND_MAX 32
+
 /*
  * There is a 1/160 chance per round of creating a new monster
  */
@@ -2361,7 +2402,7 @@
 #define OPT_forgo_attacking_unwary 6
 #define OPT_delay_factor 10
 #define OPT_hitpoint_warning 11
-// xxx always_repeat
+#define OPT_frame_budget 12
 // xxx depth_in_feet
 // xxx stack_force_notes
 // xxx stack_force_costs
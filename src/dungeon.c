@@ -468,7 +468,7 @@ static void recharged_notice(object_type* o_ptr)
 /*
  * Handle certain things once every 10 game turns
  */
-static void process_world(void)
+void process_world(void)
 {
     int i, j;
 
@@ -1540,7 +1540,7 @@ static void process_player_aux(void)
  * even if not disabled, it will only check during every 128th game turn
  * while resting, for efficiency.
  */
-static void process_player(void)
+void process_player(void)
 {
     int i;
     int amount;
@@ -1749,8 +1749,16 @@ static void process_player(void)
         else if (cheat_light)
             display_light_map();
 
-        /* Refresh */
-        Term_fresh();
+        /* Refresh (coalescing the frames of a run) */
+        if (p_ptr->running)
+        {
+            frame_fresh();
+        }
+        else
+        {
+            frame_flush();
+            Term_fresh();
+        }
 
         /* Hack -- Pack Overflow if needed */
         check_pack_overflow();
@@ -1915,7 +1923,7 @@ static void process_player(void)
             // Pause for 17 miliseconds (minimum needed for mac OS X to pause)
             if (!instant_run)
             {
-                Term_xtra(TERM_XTRA_DELAY, 17);
+                frame_delay(17);
             }
         }
 
@@ -2495,7 +2503,6 @@ static void process_player(void)
  */
 static void dungeon(void)
 {
-    monster_type* m_ptr;
     int i;
 
     /* Hack -- enforce illegal panel */
@@ -2822,18 +2829,7 @@ static void dungeon(void)
         p_ptr->energy += extract_energy[p_ptr->pspeed];
 
         /* Give energy to all monsters */
-        for (i = mon_max - 1; i >= 1; i--)
-        {
-            /* Access the monster */
-            m_ptr = &mon_list[i];
-
-            /* Ignore "dead" monsters */
-            if (!m_ptr->r_idx)
-                continue;
-
-            /* Give this monster some energy */
-            m_ptr->energy += extract_energy[m_ptr->mspeed];
-        }
+        process_monsters_energy();
 
         /* Count game turns */
         turn++;
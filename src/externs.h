@@ -106,6 +106,9 @@ extern s16b o_max;
 extern s16b o_cnt;
 extern s16b mon_max;
 extern s16b mon_cnt;
+extern u16b gen_tries;
+extern u16b gen_rooms;
+extern u16b gen_vaults;
 extern byte feeling;
 extern bool do_feeling;
 extern s16b rating;
@@ -135,7 +138,7 @@ extern s16b (*cave_o_idx)[MAX_DUNGEON_WID];
 extern s16b (*cave_m_idx)[MAX_DUNGEON_WID];
 extern u32b mon_power_ave[MAX_DEPTH][CREATURE_TYPE_MAX];
 
-extern byte cave_cost[MAX_FLOWS][MAX_DUNGEON_HGT][MAX_DUNGEON_WID];
+extern byte_wid* cave_cost[MAX_FLOWS];
 extern byte (*cave_when)[MAX_DUNGEON_WID];
 extern int scent_when;
 extern byte flow_center_y[MAX_FLOWS];
@@ -158,6 +161,10 @@ extern s16b alloc_ego_size;
 extern alloc_entry* alloc_ego_table;
 extern s16b alloc_race_size;
 extern alloc_entry* alloc_race_table;
+extern alloc_band* alloc_kind_band;
+extern alloc_band* alloc_race_band;
+extern u32b alloc_kind_stamp;
+extern u32b alloc_race_stamp;
 extern byte misc_to_attr[256];
 extern char misc_to_char[256];
 extern byte tval_to_attr[128];
@@ -260,17 +267,21 @@ extern bool use_background_colors;
 
 /* birth.c */
 extern void player_birth(void);
+extern void player_birth_quick(int race, int house);
 extern bool gain_skills(void);
 
 /* cave.c */
 extern int distance(int y1, int x1, int y2, int x2);
 extern int distance_squared(int y1, int x1, int y2, int x2);
+extern void los_cache_forget(void);
+extern void los_cache_stats(u32b* hits, u32b* misses, u32b* resets);
 extern bool los(int y1, int x1, int y2, int x2);
 extern void random_unseen_floor(int* ry, int* rx);
 extern bool no_light(void);
 extern bool seen_by_keen_senses(int y, int x);
 extern bool cave_valid_bold(int y, int x);
 extern bool feat_supports_lighting(int feat);
+extern void map_info_forget(void);
 extern void map_info(int y, int x, byte* ap, char* cp, byte* tap, char* tcp);
 extern void map_info_default(int y, int x, byte* ap, char* cp);
 extern void move_cursor_relative(int y, int x);
@@ -284,6 +295,16 @@ extern errr vinfo_init(void);
 extern void forget_view(void);
 extern void update_view(void);
 extern int flow_dist(int which_flow, int y, int x);
+extern void forget_flows(void);
+extern void flow_note_change(int y, int x);
+extern void init_flows(void);
+extern void cleanup_flows(void);
+extern void flow_release(int which_flow);
+extern void wipe_flows(void);
+extern void flow_move(int from, int to);
+extern level_context* level_context_make(void);
+extern void level_context_free(level_context* lc);
+extern void level_context_swap(level_context* lc);
 extern void update_flow(int cy, int cx, int which_flow);
 extern void update_smell(void);
 extern void map_feature(int y, int x);
@@ -484,6 +505,8 @@ extern void pseudo_id(object_type* o_ptr);
 extern void pseudo_id_everything(void);
 extern void id_known_specials(void);
 extern void id_everything(void);
+extern void process_world(void);
+extern void process_player(void);
 extern void play_game(bool new_game);
 
 /* files.c */
@@ -542,9 +565,13 @@ extern void autoinscribe_init(void);
 extern void re_init_some_things(void);
 extern int initial_menu(int* highlight);
 extern void cleanup_angband(void);
+extern alloc_band* alloc_band_find(alloc_band* band, u32b key, u32b stamp);
+extern int alloc_band_pick(const alloc_band* band, long value);
 
 /* load.c */
 extern bool load_player(void);
+extern void load_messages(void);
+extern void load_notes(void);
 
 /* melee1.c */
 extern int protection_roll(int typ, bool melee);
@@ -576,6 +603,9 @@ extern bool cave_exist_mon(
     monster_race* r_ptr, int y, int x, bool occupied_ok, bool can_dig);
 extern int cave_passable_mon(monster_type* m_ptr, int y, int x, bool* bash);
 extern void tell_allies(int y, int x, u32b flag);
+extern void mon_ready_note(int m_idx);
+extern void mon_ready_reset(void);
+extern void process_monsters_energy(void);
 extern void process_monsters(s16b minimum_energy);
 extern void calc_morale(monster_type* m_ptr);
 extern void calc_stance(monster_type* m_ptr);
@@ -905,6 +935,9 @@ extern errr macro_free(void);
 extern errr macro_trigger_free(void);
 extern void flush(void);
 extern void flush_fail(void);
+extern void frame_delay(int msec);
+extern void frame_fresh(void);
+extern void frame_flush(void);
 extern char inkey(void);
 extern void bell(cptr reason);
 extern void sound(int val);
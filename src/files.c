@@ -424,6 +424,7 @@ errr process_pref_file_command(char* buf)
                 f_ptr->x_attr = (byte)n1;
             if (n2)
                 f_ptr->x_char = (char)n2;
+            map_info_forget();
             return (0);
         }
     }
@@ -3209,6 +3210,7 @@ void do_cmd_escape(void)
     (void)strftime(long_day, 40, "%d %B %Y", localtime(&ct));
 
     /* Add note */
+    load_notes();
     my_strcat(notes_buffer, "\n", sizeof(notes_buffer));
 
     /*killed by */
@@ -4661,6 +4663,7 @@ errr file_character(cptr name, bool full)
     fprintf(fff, "\n\n  [Notes]\n\n");
 
     /*dump notes to character file*/
+    load_notes();
     i = 0;
     holder = notes_buffer[i];
 
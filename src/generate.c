@@ -2970,6 +2970,9 @@ static bool build_vault(int y0, int x0, vault_type* v_ptr, bool flip_d)
         }
     }
 
+    /* Count the vault */
+    gen_vaults++;
+
     return (TRUE);
 }
 
@@ -3763,6 +3766,9 @@ static bool cave_gen(void)
 
     p_ptr->force_forge = FALSE;
 
+    /* Remember the number of rooms */
+    gen_rooms = dun->cent_n;
+
     return (TRUE);
 }
 
@@ -3972,6 +3978,8 @@ void generate_cave(void)
 {
     int y, x, i;
 
+    PROF_ENTER(PROF_GENERATE_CAVE);
+
     /* The dungeon is not ready */
     character_dungeon = FALSE;
 
@@ -3994,6 +4002,9 @@ void generate_cave(void)
     // you fell down)
     p_ptr->skip_next_turn = FALSE;
 
+    /* No attempts yet */
+    gen_tries = 0;
+
     while (TRUE)
     {
         bool okay = TRUE;
@@ -4005,6 +4016,11 @@ void generate_cave(void)
         mon_max = 1;
         feeling = 0;
 
+        /* Count the attempts, rooms and vaults */
+        gen_tries++;
+        gen_rooms = 0;
+        gen_vaults = 0;
+
         /* Start with a blank cave */
         for (y = 0; y < MAX_DUNGEON_HGT; y++)
         {
@@ -4022,11 +4038,6 @@ void generate_cave(void)
                 /* No monsters */
                 cave_m_idx[y][x] = 0;
 
-                for (i = 0; i < MAX_FLOWS; i++)
-                {
-                    cave_cost[i][y][x] = FLOW_MAX_DIST;
-                }
-
                 cave_when[y][x] = 0;
             }
         }
@@ -4037,6 +4048,12 @@ void generate_cave(void)
             wandering_pause[i] = 0;
         }
 
+        /* No flows */
+        wipe_flows();
+
+        /* No remembered lines of sight */
+        los_cache_forget();
+
         /* Mega-Hack -- no player yet */
         p_ptr->px = p_ptr->py = 0;
 
@@ -4208,4 +4225,6 @@ void generate_cave(void)
         map_area();
         p_ptr->thrall_quest = QUEST_COMPLETE;
     }
+
+    PROF_LEAVE(PROF_GENERATE_CAVE);
 }
@@ -91,6 +91,46 @@ struct header
     parse_info_txt_func parse_info_txt;
 };
 
+/*
+ * The game data image (see "init2.c") holds a copy of each binary image
+ * file, every one starting on a page boundary so it can be mapped.  The
+ * copies are aligned to the page size of the system which wrote the image
+ * (and to at least IMAGE_ALIGN bytes).
+ */
+#define IMAGE_FILE "image.raw"
+#define IMAGE_MAGIC "SILI"
+#define IMAGE_VERSION 2
+#define IMAGE_MAX 16
+#define IMAGE_ALIGN 4096
+
+typedef struct image_entry image_entry;
+typedef struct image_header image_header;
+
+struct image_entry
+{
+    char name[16]; /* Name of the file ("monster") */
+
+    u32b offset; /* Offset of the file in the image */
+    u32b size; /* Size of the file in bytes */
+};
+
+struct image_header
+{
+    char magic[4]; /* IMAGE_MAGIC */
+
+    byte v_major; /* Version -- major */
+    byte v_minor; /* Version -- minor */
+    byte v_patch; /* Version -- patch */
+    byte v_extra; /* Version -- extra */
+
+    u16b version; /* IMAGE_VERSION */
+    u16b num; /* Number of files */
+
+    u32b align; /* Alignment of the files (a page size) */
+
+    image_entry entry[IMAGE_MAX];
+};
+
 extern errr init_info_txt(
     FILE* fp, char* buf, header* head, parse_info_txt_func parse_info_txt_line);
 
@@ -115,6 +155,7 @@ extern errr parse_flavor_info(char* buf, header* head);
  */
 extern int error_idx;
 extern int error_line;
+extern bool error_quiet;
 
 #endif /* ALLOW_TEMPLATES */
 
@@ -138,4 +179,11 @@ extern header q_head;
 extern header n_head;
 extern header flavor_head;
 
+/*
+ * Template files parsed during startup, and the time spent on each
+ */
+extern cptr parse_file[IMAGE_MAX];
+extern double parse_time[IMAGE_MAX];
+extern int parse_num;
+
 #endif /* INCLUDED_INIT_H */
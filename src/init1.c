@@ -847,30 +847,117 @@ errr parse_f_info(char* buf, header* head)
     return (0);
 }
 
+/*
+ * Hash table of the flag names, built on first use
+ *
+ * Each slot holds one more than the index of the first entry of
+ * "info_flags" with some name (zero marks an empty slot).  Later entries
+ * with the same name (in another set) are chained in table order through
+ * "flag_next", so a lookup finds the same entry the table scan did.
+ */
+#define FLAG_HASH_SIZE 1024
+
+static u16b flag_hash[FLAG_HASH_SIZE];
+static u16b flag_next[N_ELEMENTS(info_flags)];
+static bool flag_hash_ready = FALSE;
+
+/*
+ * Hash a flag name (FNV-1a)
+ */
+static u32b flag_hash_name(cptr s)
+{
+    u32b h = 2166136261UL;
+
+    while (*s)
+    {
+        h ^= (byte)*s++;
+        h *= 16777619UL;
+    }
+
+    return (h & (FLAG_HASH_SIZE - 1));
+}
+
+/*
+ * Build the hash table of the flag names
+ */
+static void flag_hash_init(void)
+{
+    uint i, j;
+
+    for (i = 0; i < N_ELEMENTS(info_flags); i++)
+    {
+        u32b h = flag_hash_name(info_flags[i].name);
+
+        /* Find the name, or an empty slot */
+        while (flag_hash[h])
+        {
+            j = flag_hash[h] - 1;
+
+            if (streq(info_flags[j].name, info_flags[i].name))
+                break;
+
+            h = (h + 1) & (FLAG_HASH_SIZE - 1);
+        }
+
+        /* A new name */
+        if (!flag_hash[h])
+        {
+            flag_hash[h] = (u16b)(i + 1);
+            continue;
+        }
+
+        /* Another set with a known name goes at the end of the chain */
+        for (j = flag_hash[h] - 1; flag_next[j]; j = flag_next[j] - 1)
+            ;
+        flag_next[j] = (u16b)(i + 1);
+    }
+
+    flag_hash_ready = TRUE;
+}
+
 /*
  * Grab one flag from a textual string
  */
 static errr grab_one_flag(u32b** flag, cptr errstr, cptr what)
 {
-    uint i;
+    u32b h;
 
-    /* Check flags */
-    for (i = 0; i < N_ELEMENTS(info_flags); i++)
+    /* Hash the names */
+    if (!flag_hash_ready)
+        flag_hash_init();
+
+    /* Find the name */
+    for (h = flag_hash_name(what); flag_hash[h];
+         h = (h + 1) & (FLAG_HASH_SIZE - 1))
     {
-        flag_name* f_ptr = info_flags + i;
+        uint i = flag_hash[h] - 1;
 
-        if (!flag[f_ptr->set])
+        if (!streq(what, info_flags[i].name))
             continue;
 
-        if (streq(what, f_ptr->name))
+        /* Check the sets with that name */
+        while (TRUE)
         {
-            *(flag[f_ptr->set]) |= f_ptr->flag;
-            return 0;
+            flag_name* f_ptr = info_flags + i;
+
+            if (flag[f_ptr->set])
+            {
+                *(flag[f_ptr->set]) |= f_ptr->flag;
+                return 0;
+            }
+
+            if (!flag_next[i])
+                break;
+
+            i = flag_next[i] - 1;
         }
+
+        break;
     }
 
     /* Oops */
-    msg_format("Unknown %s flag '%s'.", errstr, what);
+    if (!error_quiet)
+        msg_format("Unknown %s flag '%s'.", errstr, what);
 
     /* Error */
     return (-1);
@@ -1547,7 +1634,8 @@ static errr grab_one_activation(artefact_type* a_ptr, cptr what)
     }
 
     /* Oops */
-    msg_format("Unknown artefact activation '%s'.", what);
+    if (!error_quiet)
+        msg_format("Unknown artefact activation '%s'.", what);
 
     /* Error */
     return (PARSE_ERROR_GENERIC);
@@ -12,6 +12,11 @@
 
 #include "init.h"
 
+#ifdef SET_UID
+#include <sys/mman.h>
+#include <sys/wait.h>
+#endif /* SET_UID */
+
 #ifdef RUNTIME_PRIVATE_USER_PATH
 /*
  * This is a hook so the main program can set a runtime value for the private
@@ -258,6 +263,11 @@ void init_file_paths(char* path)
 int error_idx;
 int error_line;
 
+/*
+ * Hack -- parsing in a worker, which must not touch the screen
+ */
+bool error_quiet;
+
 /*
  * Standard error message text
  */
@@ -304,8 +314,31 @@ header flavor_head;
 header q_head;
 header n_head;
 
+/*
+ * The template files parsed during startup, and the time spent on each
+ * (in milliseconds)
+ */
+cptr parse_file[IMAGE_MAX];
+double parse_time[IMAGE_MAX];
+int parse_num;
+
 /*** Initialize from binary image files ***/
 
+/*
+ * Check the header of a binary image file against the one expected
+ */
+static bool init_info_head_okay(const header* test, const header* head)
+{
+    return ((test->v_major == head->v_major)
+        && (test->v_minor == head->v_minor)
+        && (test->v_patch == head->v_patch)
+        && (test->v_extra == head->v_extra)
+        && (test->info_num == head->info_num)
+        && (test->info_len == head->info_len)
+        && (test->head_size == head->head_size)
+        && (test->info_size == head->info_size));
+}
+
 /*
  * Initialize a "*_info" array, by parsing a binary "image" file
  */
@@ -315,12 +348,7 @@ static errr init_info_raw(int fd, header* head)
 
     /* Read and verify the header */
     if (fd_read(fd, (char*)(&test), sizeof(header))
-        || (test.v_major != head->v_major) || (test.v_minor != head->v_minor)
-        || (test.v_patch != head->v_patch) || (test.v_extra != head->v_extra)
-        || (test.info_num != head->info_num)
-        || (test.info_len != head->info_len)
-        || (test.head_size != head->head_size)
-        || (test.info_size != head->info_size))
+        || !init_info_head_okay(&test, head))
     {
         /* Error */
         return (-1);
@@ -380,6 +408,384 @@ static void init_header(header* head, int num, int len)
     head->info_size = head->info_num * head->info_len;
 }
 
+/*** Initialize from the game data image ***/
+
+/*
+ * The game data image is a single file holding a copy of every binary
+ * image file.  Each copy starts on a page boundary, and is mapped into
+ * memory and used where it lies, rather than being read.  The mappings
+ * are private, so pages which are never written (the names, the text,
+ * and most records) are shared by every copy of the game running, and
+ * only the pages holding things like "cur_num" are copied when written.
+ *
+ * Systems without "mmap()" read each copy with a single "fd_read()", as
+ * do systems whose pages are larger than the alignment of the image (it
+ * may have been written on another system), or which fail to map it.
+ *
+ * The image is rebuilt from the binary image files whenever one of the
+ * files could not be found in it (or was older than its template).
+ */
+
+/*
+ * The files wanted in the image, in the order they were first loaded
+ */
+static cptr image_name[IMAGE_MAX];
+static int image_num;
+
+/*
+ * Some file had to be loaded from somewhere other than the image
+ */
+static bool image_stale;
+
+/*
+ * The headers using a part of the image, and where that part lies
+ */
+static header* image_head[IMAGE_MAX];
+static char* image_base[IMAGE_MAX];
+static size_t image_size[IMAGE_MAX];
+static bool image_mapped[IMAGE_MAX];
+
+/*
+ * The alignment of the files in an image written here (the page size)
+ */
+static u32b image_align(void)
+{
+#ifdef SET_UID
+    long page = sysconf(_SC_PAGESIZE);
+
+    if (page > IMAGE_ALIGN)
+        return ((u32b)page);
+#endif /* SET_UID */
+
+    return (IMAGE_ALIGN);
+}
+
+/*
+ * Remember that a file belongs in the image
+ */
+static void image_want(cptr filename)
+{
+    int i;
+
+    for (i = 0; i < image_num; i++)
+    {
+        if (streq(image_name[i], filename))
+            return;
+    }
+
+    if (image_num < IMAGE_MAX)
+        image_name[image_num++] = filename;
+}
+
+/*
+ * Let go of a part of the image
+ */
+static void image_release(char* base, size_t size, bool mapped)
+{
+#ifdef SET_UID
+    if (mapped)
+    {
+        (void)munmap(base, size);
+        return;
+    }
+#endif /* SET_UID */
+
+    (void)size;
+    (void)mapped;
+    FREE(base);
+}
+
+/*
+ * Initialize a "*_info" array from its copy in the game data image
+ */
+static errr init_info_image(cptr filename, header* head)
+{
+    int fd, i, slot;
+
+    image_header image;
+    image_entry* e_ptr = NULL;
+
+    header* test;
+
+    char* base = NULL;
+    size_t size;
+    bool mapped = FALSE;
+
+    char buf[1024];
+
+    /* Find a free slot */
+    for (slot = 0; slot < IMAGE_MAX; slot++)
+    {
+        if (!image_head[slot])
+            break;
+    }
+    if (slot == IMAGE_MAX)
+        return (-1);
+
+    /* Build the filename */
+    path_build(buf, sizeof(buf), ANGBAND_DIR_DATA, IMAGE_FILE);
+
+    /* Attempt to open the image */
+    fd = fd_open(buf, O_RDONLY);
+    if (fd < 0)
+        return (-1);
+
+    /* Read and verify the image header */
+    if (fd_read(fd, (char*)(&image), sizeof(image_header))
+        || memcmp(image.magic, IMAGE_MAGIC, sizeof(image.magic))
+        || (image.v_major != VERSION_MAJOR) || (image.v_minor != VERSION_MINOR)
+        || (image.v_patch != VERSION_PATCH) || (image.v_extra != VERSION_EXTRA)
+        || (image.version != IMAGE_VERSION) || (image.num > IMAGE_MAX)
+        || (image.align < IMAGE_ALIGN))
+    {
+        fd_close(fd);
+        return (-1);
+    }
+
+    /* Find the file */
+    for (i = 0; i < image.num; i++)
+    {
+        if (!strncmp(
+                image.entry[i].name, filename, sizeof(image.entry[i].name)))
+        {
+            e_ptr = &image.entry[i];
+        }
+    }
+
+#ifdef CHECK_MODIFICATION_TIME
+
+    /* The template may be newer than the image */
+    if (e_ptr && check_modification_date(fd, format("%s.txt", filename)))
+        e_ptr = NULL;
+
+#endif /* CHECK_MODIFICATION_TIME */
+
+    /* Not there, or too small */
+    if (!e_ptr || (e_ptr->size < sizeof(header))
+        || (e_ptr->offset % image.align))
+    {
+        fd_close(fd);
+        return (-1);
+    }
+
+    size = e_ptr->size;
+
+#ifdef SET_UID
+
+    /* Map the file, if it lies on a page boundary here */
+    if (!(e_ptr->offset % image_align()))
+    {
+        base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd,
+            (off_t)e_ptr->offset);
+        if (base == MAP_FAILED)
+            base = NULL;
+        else
+            mapped = TRUE;
+    }
+
+#endif /* SET_UID */
+
+    /* Otherwise read the file */
+    if (!base)
+    {
+        C_MAKE(base, size, char);
+        if (fd_seek(fd, (long)e_ptr->offset) || fd_read(fd, base, size))
+            KILL(base);
+    }
+
+    /* Close the image */
+    fd_close(fd);
+
+    /* Failure */
+    if (!base)
+        return (-1);
+
+    /* Verify the header of the file */
+    test = (header*)base;
+    if (!init_info_head_okay(test, head)
+        || (size != test->head_size + test->info_size + test->name_size
+                + test->text_size))
+    {
+        image_release(base, size, mapped);
+        return (-1);
+    }
+
+    /* Accept the sizes */
+    head->name_size = test->name_size;
+    head->text_size = test->text_size;
+
+    /* Use the arrays where they lie */
+    if (head->info_size)
+        head->info_ptr = base + head->head_size;
+
+    if (head->name_size)
+        head->name_ptr = base + head->head_size + head->info_size;
+
+    if (head->text_size)
+    {
+        head->text_ptr
+            = base + head->head_size + head->info_size + head->name_size;
+    }
+
+    /* Remember the part of the image in use */
+    image_head[slot] = head;
+    image_base[slot] = base;
+    image_size[slot] = size;
+    image_mapped[slot] = mapped;
+
+    /* Success */
+    return (0);
+}
+
+/*
+ * Free the arrays of a "*_info" array taken from the game data image
+ */
+static bool free_info_image(header* head)
+{
+    int i;
+
+    for (i = 0; i < IMAGE_MAX; i++)
+    {
+        if (image_head[i] != head)
+            continue;
+
+        image_release(image_base[i], image_size[i], image_mapped[i]);
+
+        image_head[i] = NULL;
+        image_base[i] = NULL;
+
+        head->info_ptr = NULL;
+        head->name_ptr = NULL;
+        head->text_ptr = NULL;
+
+        return (TRUE);
+    }
+
+    return (FALSE);
+}
+
+/*
+ * Rebuild the game data image from the binary image files
+ *
+ * The new image is written beside the old one and then moved over it,
+ * so that games which have mapped the old one are left undisturbed.
+ */
+static void save_info_image(void)
+{
+    int fd, raw_fd, i;
+    int num = 0;
+
+    image_header image;
+    header test;
+
+    u32b align = image_align();
+    u32b offset = align;
+    u32b size;
+
+    char* data;
+
+    bool ok = TRUE;
+
+    char buf[1024];
+    char temp[1024];
+
+    /* Build the filenames */
+    path_build(buf, sizeof(buf), ANGBAND_DIR_DATA, IMAGE_FILE);
+    strnfmt(temp, sizeof(temp), "%s.new", buf);
+
+    /* Prepare the image header */
+    WIPE(&image, image_header);
+    memcpy(image.magic, IMAGE_MAGIC, sizeof(image.magic));
+    image.v_major = VERSION_MAJOR;
+    image.v_minor = VERSION_MINOR;
+    image.v_patch = VERSION_PATCH;
+    image.v_extra = VERSION_EXTRA;
+    image.version = IMAGE_VERSION;
+    image.align = align;
+
+    /* File type is "DATA" */
+    FILE_TYPE(FILE_TYPE_DATA);
+
+    /* Grab permissions */
+    safe_setuid_grab();
+
+    /* Create the new image */
+    fd_kill(temp);
+    fd = fd_make(temp, 0644);
+
+    /* Drop permissions */
+    safe_setuid_drop();
+
+    /* Failure */
+    if (fd < 0)
+        return;
+
+    /* Copy each binary image file */
+    for (i = 0; ok && (i < image_num); i++)
+    {
+        /* Open the file */
+        path_build(buf, sizeof(buf), ANGBAND_DIR_DATA,
+            format("%s.raw", image_name[i]));
+        raw_fd = fd_open(buf, O_RDONLY);
+
+        /* Leave out missing files (they are rebuilt next time) */
+        if (raw_fd < 0)
+            continue;
+
+        /* Measure it */
+        if (fd_read(raw_fd, (char*)(&test), sizeof(header))
+            || (test.head_size != sizeof(header)))
+        {
+            fd_close(raw_fd);
+            ok = FALSE;
+            break;
+        }
+        size = test.head_size + test.info_size + test.name_size
+            + test.text_size;
+
+        /* Copy it */
+        C_MAKE(data, size, char);
+        if (fd_seek(raw_fd, 0L) || fd_read(raw_fd, data, size)
+            || fd_seek(fd, (long)offset) || fd_write(fd, data, size))
+        {
+            ok = FALSE;
+        }
+        FREE(data);
+        fd_close(raw_fd);
+
+        /* Note it */
+        my_strcpy(image.entry[num].name, image_name[i],
+            sizeof(image.entry[num].name));
+        image.entry[num].offset = offset;
+        image.entry[num].size = size;
+        num++;
+
+        /* The next file starts on a new page */
+        offset += (size + align - 1) / align * align;
+    }
+
+    /* Write the image header */
+    image.num = (u16b)num;
+    if (ok && (fd_seek(fd, 0L) || fd_write(fd, (cptr)&image, sizeof(image))))
+        ok = FALSE;
+
+    /* Close it */
+    fd_close(fd);
+
+    /* Grab permissions */
+    safe_setuid_grab();
+
+    /* Replace the old image */
+    path_build(buf, sizeof(buf), ANGBAND_DIR_DATA, IMAGE_FILE);
+    if (ok)
+        fd_move(temp, buf);
+    else
+        fd_kill(temp);
+
+    /* Drop permissions */
+    safe_setuid_drop();
+}
+
 #ifdef ALLOW_TEMPLATES
 
 /*
@@ -405,177 +811,435 @@ static void display_parse_error(cptr filename, errr err, cptr buf)
 #endif /* ALLOW_TEMPLATES */
 
 /*
- * Initialize a "*_info" array
- *
- * Note that we let each entry have a unique "name" and "text" string,
- * even if the string happens to be empty (everyone has a unique '\0').
+ * Free the allocated memory for the info-, name-, and text- arrays.
  */
-static errr init_info(cptr filename, header* head)
+static errr free_info(header* head)
 {
-    int fd;
+    /* Release a part of the game data image */
+    if (free_info_image(head))
+        return (0);
 
-    errr err = 1;
+    if (head->info_size)
+        FREE(head->info_ptr);
 
-    FILE* fp;
+    if (head->name_size)
+        FREE(head->name_ptr);
 
-    /* General buffer */
-    char buf[1024];
+    if (head->text_size)
+        FREE(head->text_ptr);
+
+    /* Success */
+    return (0);
+}
 
 #ifdef ALLOW_TEMPLATES
 
-    /*** Load the binary image file ***/
+/*
+ * Remember the time spent parsing a template file
+ */
+static void parse_note(cptr filename, double ms)
+{
+    if (parse_num >= IMAGE_MAX)
+        return;
 
-    /* Build the filename */
-    path_build(buf, sizeof(buf), ANGBAND_DIR_DATA, format("%s.raw", filename));
+    parse_file[parse_num] = filename;
+    parse_time[parse_num] = ms;
+    parse_num++;
+}
 
-    /* Attempt to open the "raw" file */
-    fd = fd_open(buf, O_RDONLY);
+/*
+ * Parse an ascii template file into fresh "fake" arrays
+ *
+ * The buffer must hold 1024 characters.  It holds the last line read.
+ */
+static errr init_info_parse(cptr filename, header* head, char* buf)
+{
+    errr err;
 
-    /* Process existing "raw" file */
-    if (fd >= 0)
-    {
-#ifdef CHECK_MODIFICATION_TIME
+    FILE* fp;
 
-        err = check_modification_date(fd, format("%s.txt", filename));
+    char name[80];
 
-#endif /* CHECK_MODIFICATION_TIME */
+    /*** Make the fake arrays ***/
 
-        /* Attempt to parse the "raw" file */
-        if (!err)
-            err = init_info_raw(fd, head);
+    /* Allocate the "*_info" array */
+    C_MAKE(head->info_ptr, head->info_size, char);
 
-        /* Close it */
-        fd_close(fd);
+    /* MegaHack -- make "fake" arrays */
+    if (z_info)
+    {
+        C_MAKE(head->name_ptr, z_info->fake_name_size, char);
+        C_MAKE(head->text_ptr, z_info->fake_text_size, char);
     }
 
-    /* Do we have to parse the *.txt file? */
-    if (err)
+    /*** Load the ascii template file ***/
+
+    /* Build the filename */
+    strnfmt(name, sizeof(name), "%s.txt", filename);
+    path_build(buf, 1024, ANGBAND_DIR_EDIT, name);
+
+    /* Open the file */
+    fp = my_fopen(buf, "r");
+
+    /* Parse it */
+    if (!fp)
     {
-        /*** Make the fake arrays ***/
+        /* A worker leaves the complaint to the game */
+        if (error_quiet)
+            return (PARSE_ERROR_GENERIC);
 
-        /* Allocate the "*_info" array */
-        C_MAKE(head->info_ptr, head->info_size, char);
+        quit(format("Cannot open '%s.txt' file.", filename));
+    }
 
-        /* MegaHack -- make "fake" arrays */
-        if (z_info)
-        {
-            C_MAKE(head->name_ptr, z_info->fake_name_size, char);
-            C_MAKE(head->text_ptr, z_info->fake_text_size, char);
-        }
+    /* Parse the file */
+    err = init_info_txt(fp, buf, head, head->parse_info_txt);
 
-        /*** Load the ascii template file ***/
+    /* Close it */
+    my_fclose(fp);
 
-        /* Build the filename */
-        path_build(
-            buf, sizeof(buf), ANGBAND_DIR_EDIT, format("%s.txt", filename));
+    return (err);
+}
 
-        /* Open the file */
-        fp = my_fopen(buf, "r");
+/*
+ * Dump the "fake" arrays into a binary image file, and free them
+ *
+ * If the file cannot be written, the arrays are kept (and used).
+ */
+static errr init_info_dump(cptr filename, header* head, char* buf)
+{
+    int fd;
 
-        /* Parse it */
-        if (!fp)
-            quit(format("Cannot open '%s.txt' file.", filename));
+    char name[80];
 
-        /* Parse the file */
-        err = init_info_txt(fp, buf, head, head->parse_info_txt);
+    /* File type is "DATA" */
+    FILE_TYPE(FILE_TYPE_DATA);
 
-        /* Close it */
-        my_fclose(fp);
+    /* Build the filename */
+    strnfmt(name, sizeof(name), "%s.raw", filename);
+    path_build(buf, 1024, ANGBAND_DIR_DATA, name);
 
-        /* Errors */
-        if (err)
-            display_parse_error(filename, err, buf);
+    /* Attempt to open the file */
+    fd = fd_open(buf, O_RDONLY);
 
-        /*** Dump the binary image file ***/
+    /* Failure */
+    if (fd < 0)
+    {
+        int mode = 0644;
 
-        /* File type is "DATA" */
-        FILE_TYPE(FILE_TYPE_DATA);
+        /* Grab permissions */
+        safe_setuid_grab();
 
-        /* Build the filename */
-        path_build(
-            buf, sizeof(buf), ANGBAND_DIR_DATA, format("%s.raw", filename));
+        /* Create a new file */
+        fd = fd_make(buf, mode);
 
-        /* Attempt to open the file */
-        fd = fd_open(buf, O_RDONLY);
+        /* Drop permissions */
+        safe_setuid_drop();
 
         /* Failure */
         if (fd < 0)
         {
-            int mode = 0644;
+            /* Complain */
+            if (!error_quiet)
+                plog_fmt("Cannot create the '%s' file!", buf);
 
-            /* Grab permissions */
-            safe_setuid_grab();
+            /* Continue */
+            return (-1);
+        }
+    }
 
-            /* Create a new file */
-            fd = fd_make(buf, mode);
+    /* Close it */
+    fd_close(fd);
 
-            /* Drop permissions */
-            safe_setuid_drop();
+    /* Grab permissions */
+    safe_setuid_grab();
 
-            /* Failure */
-            if (fd < 0)
-            {
-                /* Complain */
-                plog_fmt("Cannot create the '%s' file!", buf);
+    /* Attempt to create the raw file */
+    fd = fd_open(buf, O_WRONLY);
 
-                /* Continue */
-                return (0);
-            }
-        }
+    /* Drop permissions */
+    safe_setuid_drop();
 
-        /* Close it */
-        fd_close(fd);
+    /* Failure */
+    if (fd < 0)
+    {
+        /* Complain */
+        if (!error_quiet)
+            plog_fmt("Cannot write the '%s' file!", buf);
 
-        /* Grab permissions */
-        safe_setuid_grab();
+        /* Continue */
+        return (-1);
+    }
 
-        /* Attempt to create the raw file */
-        fd = fd_open(buf, O_WRONLY);
+    /* Dump it */
+    fd_write(fd, (cptr)head, head->head_size);
 
-        /* Drop permissions */
-        safe_setuid_drop();
+    /* Dump the "*_info" array */
+    fd_write(fd, head->info_ptr, head->info_size);
 
-        /* Failure */
-        if (fd < 0)
-        {
-            /* Complain */
-            plog_fmt("Cannot write the '%s' file!", buf);
+    /* Dump the "*_name" array */
+    fd_write(fd, head->name_ptr, head->name_size);
 
-            /* Continue */
-            return (0);
+    /* Dump the "*_text" array */
+    fd_write(fd, head->text_ptr, head->text_size);
+
+    /* Close */
+    fd_close(fd);
+
+    /*** Kill the fake arrays ***/
+
+    /* Free the "*_info" array */
+    KILL(head->info_ptr);
+
+    /* MegaHack -- Free the "fake" arrays */
+    if (z_info)
+    {
+        KILL(head->name_ptr);
+        KILL(head->text_ptr);
+    }
+
+    return (0);
+}
+
+/*
+ * Template files found to be stale while "init_info_collect" is set,
+ * which "init_info_parallel()" parses side by side
+ */
+static bool init_info_collect;
+static cptr job_file[IMAGE_MAX];
+static header job_head[IMAGE_MAX];
+static int job_num;
+
+/*
+ * Leave a template file for "init_info_parallel()"
+ */
+static void init_info_queue(cptr filename, const header* head)
+{
+    if (job_num >= IMAGE_MAX)
+        return;
+
+    job_file[job_num] = filename;
+    COPY(&job_head[job_num], head, header);
+    job_num++;
+}
+
+#ifdef SET_UID
+
+/*
+ * Wait for a parsing worker, and collect its time
+ */
+static void init_info_wait(cptr filename, pid_t pid, int fd)
+{
+    double ms;
+
+    /* A worker only reports a file it has written */
+    if (read(fd, &ms, sizeof(ms)) == sizeof(ms))
+        parse_note(filename, ms);
+
+    (void)close(fd);
+    (void)waitpid(pid, NULL, 0);
+}
+
+#endif /* SET_UID */
+
+/*
+ * Parse the template files left by "init_info()" side by side
+ *
+ * Each file is parsed by a worker process of its own (as many at once
+ * as there are processors), which writes the binary image file and
+ * reports the time it took.  The files are then loaded one after the
+ * other as usual, so the result does not depend on which worker ends
+ * first.  A file whose worker failed is still stale, and is parsed
+ * again by "init_info()" itself, which reports the error.
+ *
+ * Systems without "fork()" parse every file in "init_info()".
+ */
+static void init_info_parallel(void)
+{
+#ifdef SET_UID
+
+    int i, first = 0;
+
+    int workers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+    pid_t pid[IMAGE_MAX];
+    int pipe_fd[IMAGE_MAX];
+
+    if (workers < 1)
+        workers = 1;
+
+    /* Do not flush the same output from every worker */
+    (void)fflush(stdout);
+
+    for (i = 0; i < job_num; i++)
+    {
+        int fds[2];
+
+        /* Wait for a free processor */
+        if (i - first >= workers)
+        {
+            if (pid[first] > 0)
+                init_info_wait(job_file[first], pid[first], pipe_fd[first]);
+            first++;
         }
 
-        /* Dump to the file */
-        if (fd >= 0)
+        /* No worker, no report */
+        pid[i] = -1;
+        pipe_fd[i] = -1;
+
+        if (pipe(fds))
+            continue;
+
+        pid[i] = fork();
+
+        /* The worker */
+        if (pid[i] == 0)
         {
-            /* Dump it */
-            fd_write(fd, (cptr)head, head->head_size);
+            char buf[1024];
+
+            double start = clock_msec();
+            double ms;
+
+            errr err;
 
-            /* Dump the "*_info" array */
-            fd_write(fd, head->info_ptr, head->info_size);
+            (void)close(fds[0]);
 
-            /* Dump the "*_name" array */
-            fd_write(fd, head->name_ptr, head->name_size);
+            /* Leave the screen alone */
+            error_quiet = TRUE;
 
-            /* Dump the "*_text" array */
-            fd_write(fd, head->text_ptr, head->text_size);
+            err = init_info_parse(job_file[i], &job_head[i], buf);
+            if (!err)
+                err = init_info_dump(job_file[i], &job_head[i], buf);
 
-            /* Close */
-            fd_close(fd);
+            /* Report the time */
+            ms = clock_msec() - start;
+            if (!err)
+                (void)write(fds[1], &ms, sizeof(ms));
+
+            _exit(err ? 1 : 0);
         }
 
-        /*** Kill the fake arrays ***/
+        (void)close(fds[1]);
+
+        /* No worker */
+        if (pid[i] < 0)
+            (void)close(fds[0]);
+        else
+            pipe_fd[i] = fds[0];
+    }
+
+    /* Wait for the rest */
+    for (; first < job_num; first++)
+    {
+        if (pid[first] > 0)
+            init_info_wait(job_file[first], pid[first], pipe_fd[first]);
+    }
+
+#endif /* SET_UID */
+
+    /* Done */
+    job_num = 0;
+}
+
+#endif /* ALLOW_TEMPLATES */
+
+/*
+ * Initialize a "*_info" array
+ *
+ * Note that we let each entry have a unique "name" and "text" string,
+ * even if the string happens to be empty (everyone has a unique '\0').
+ */
+static errr init_info(cptr filename, header* head)
+{
+    int fd;
+
+    errr err = 1;
+
+#ifdef ALLOW_TEMPLATES
+    double start;
+#endif /* ALLOW_TEMPLATES */
+
+    /* General buffer */
+    char buf[1024];
+
+    /*** Use the game data image ***/
 
-        /* Free the "*_info" array */
-        KILL(head->info_ptr);
+    /* Remember the file */
+    image_want(filename);
 
-        /* MegaHack -- Free the "fake" arrays */
-        if (z_info)
+    /* Map it from the image */
+    if (!init_info_image(filename, head))
+    {
+#ifdef ALLOW_TEMPLATES
+        /* Only looking */
+        if (init_info_collect)
+            free_info_image(head);
+#endif /* ALLOW_TEMPLATES */
+
+        return (0);
+    }
+
+    /* The image needs rebuilding */
+    image_stale = TRUE;
+
+#ifdef ALLOW_TEMPLATES
+
+    /*** Load the binary image file ***/
+
+    /* Build the filename */
+    path_build(buf, sizeof(buf), ANGBAND_DIR_DATA, format("%s.raw", filename));
+
+    /* Attempt to open the "raw" file */
+    fd = fd_open(buf, O_RDONLY);
+
+    /* Process existing "raw" file */
+    if (fd >= 0)
+    {
+#ifdef CHECK_MODIFICATION_TIME
+
+        err = check_modification_date(fd, format("%s.txt", filename));
+
+#endif /* CHECK_MODIFICATION_TIME */
+
+        /* Attempt to parse the "raw" file */
+        if (!err)
+            err = init_info_raw(fd, head);
+
+        /* Close it */
+        fd_close(fd);
+
+        /* Only looking */
+        if (!err && init_info_collect)
+            free_info(head);
+    }
+
+    /* Do we have to parse the *.txt file? */
+    if (err)
+    {
+        /* Leave it for "init_info_parallel()" */
+        if (init_info_collect)
         {
-            KILL(head->name_ptr);
-            KILL(head->text_ptr);
+            init_info_queue(filename, head);
+            return (0);
         }
 
+        /*** Parse the ascii template file ***/
+
+        start = clock_msec();
+
+        err = init_info_parse(filename, head, buf);
+
+        /* Errors */
+        if (err)
+            display_parse_error(filename, err, buf);
+
+        parse_note(filename, clock_msec() - start);
+
+        /*** Dump the binary image file ***/
+
+        /* Keep the "fake" arrays if the file cannot be written */
+        if (init_info_dump(filename, head, buf))
+            return (0);
+
 #endif /* ALLOW_TEMPLATES */
 
         /*** Load the binary image file ***/
@@ -609,24 +1273,6 @@ static errr init_info(cptr filename, header* head)
     return (0);
 }
 
-/*
- * Free the allocated memory for the info-, name-, and text- arrays.
- */
-static errr free_info(header* head)
-{
-    if (head->info_size)
-        FREE(head->info_ptr);
-
-    if (head->name_size)
-        FREE(head->name_ptr);
-
-    if (head->text_size)
-        FREE(head->text_ptr);
-
-    /* Success */
-    return (0);
-}
-
 /*
  * Initialize the "z_info" array
  */
@@ -1078,6 +1724,7 @@ extern void re_init_some_things(void)
     /* Flow arrays */
     FREE(cave_when);
     C_MAKE(cave_when, MAX_DUNGEON_HGT, byte_wid);
+    init_flows();
 
     /*** Prepare "vinfo" array ***/
 
@@ -1194,6 +1841,7 @@ static errr init_other(void)
 
     /* Flow arrays */
     C_MAKE(cave_when, MAX_DUNGEON_HGT, byte_wid);
+    init_flows();
 
     /*** Prepare "vinfo" array ***/
 
@@ -1252,6 +1900,103 @@ static errr init_other(void)
     return (0);
 }
 
+/*
+ * Allocate the cached bands for an allocation table of "size" entries
+ */
+static alloc_band* alloc_band_make(int size)
+{
+    int i;
+
+    alloc_band* band;
+
+    C_MAKE(band, ALLOC_BAND_MAX, alloc_band);
+
+    for (i = 0; i < ALLOC_BAND_MAX; i++)
+    {
+        band[i].num = -1;
+        C_MAKE(band[i].total, size, s32b);
+    }
+
+    return (band);
+}
+
+/*
+ * Free the cached bands of an allocation table
+ */
+static void alloc_band_free(alloc_band* band)
+{
+    int i;
+
+    if (!band)
+        return;
+
+    for (i = 0; i < ALLOC_BAND_MAX; i++)
+        FREE(band[i].total);
+
+    FREE(band);
+}
+
+/*
+ * Find the cached band for "key" built at "stamp"
+ *
+ * If there is none, the least recently used band is returned with "num"
+ * set to -1, and the caller must fill it in.
+ */
+alloc_band* alloc_band_find(alloc_band* band, u32b key, u32b stamp)
+{
+    static u32b tick = 0;
+
+    int i, old = 0;
+
+    tick++;
+
+    for (i = 0; i < ALLOC_BAND_MAX; i++)
+    {
+        /* Found it */
+        if ((band[i].num >= 0) && (band[i].key == key)
+            && (band[i].stamp == stamp))
+        {
+            band[i].used = tick;
+            return (&band[i]);
+        }
+
+        /* Track the oldest */
+        if (band[i].used < band[old].used)
+            old = i;
+    }
+
+    /* Claim the oldest band */
+    band[old].key = key;
+    band[old].stamp = stamp;
+    band[old].used = tick;
+    band[old].num = -1;
+
+    return (&band[old]);
+}
+
+/*
+ * Pick the first entry of a band whose running total exceeds "value"
+ *
+ * This is the entry the old linear walk (subtracting each "prob3" from
+ * "value" in turn) would stop at, so the same roll gives the same entry.
+ */
+int alloc_band_pick(const alloc_band* band, long value)
+{
+    int lo = 0, hi = band->num - 1;
+
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+
+        if (band->total[mid] > value)
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+
+    return (lo);
+}
+
 /*
  * Initialize some other arrays
  */
@@ -1317,6 +2062,9 @@ static errr init_alloc(void)
     /* Allocate the alloc_kind_table */
     C_MAKE(alloc_kind_table, alloc_kind_size, alloc_entry);
 
+    /* Allocate its cached bands */
+    alloc_kind_band = alloc_band_make(alloc_kind_size);
+
     /* Get the table entry */
     table = alloc_kind_table;
 
@@ -1401,6 +2149,9 @@ static errr init_alloc(void)
     /* Allocate the alloc_race_table */
     C_MAKE(alloc_race_table, alloc_race_size, alloc_entry);
 
+    /* Allocate its cached bands */
+    alloc_race_band = alloc_band_make(alloc_race_size);
+
     /* Get the table entry */
     table = alloc_race_table;
 
@@ -1677,6 +2428,28 @@ void init_angband(void)
     if (init_z_info())
         quit("Cannot initialize sizes");
 
+#ifdef ALLOW_TEMPLATES
+
+    /* Parse any stale template files side by side */
+    note("[Checking template files...]");
+    init_info_collect = TRUE;
+    (void)init_f_info();
+    (void)init_k_info();
+    (void)init_b_info();
+    (void)init_a_info();
+    (void)init_e_info();
+    (void)init_r_info();
+    (void)init_v_info();
+    (void)init_h_info();
+    (void)init_p_info();
+    (void)init_c_info();
+    (void)init_flavor_info();
+    (void)init_n_info();
+    init_info_collect = FALSE;
+    init_info_parallel();
+
+#endif /* ALLOW_TEMPLATES */
+
     /* Initialize feature info */
     note("[Initializing arrays... (features)]");
     if (init_f_info())
@@ -1757,6 +2530,14 @@ void init_angband(void)
     if (init_n_info())
         quit("Cannot initialize random name generator stuff");
 
+    /* Rebuild the game data image for the next time */
+    if (image_stale)
+    {
+        note("[Building the game data image...]");
+        save_info_image();
+        image_stale = FALSE;
+    }
+
     /*Build the randart probability tables based on the standard Artefact Set*/
     build_randart_tables();
 
@@ -1873,6 +2654,8 @@ void cleanup_angband(void)
     FREE(alloc_ego_table);
     FREE(alloc_race_table);
     FREE(alloc_kind_table);
+    alloc_band_free(alloc_race_band);
+    alloc_band_free(alloc_kind_band);
 
     /* Free the player inventory */
     FREE(inventory);
@@ -1887,6 +2670,7 @@ void cleanup_angband(void)
 
     /* Flow arrays */
     FREE(cave_when);
+    cleanup_flows();
 
     /* Free the cave */
     FREE(cave_o_idx);
@@ -38,9 +38,29 @@
  */
 
 /*
- * Local "savefile" pointer
+ * The whole savefile, read into memory
  */
-static FILE* fff;
+static byte* sf_buf;
+static size_t sf_size;
+
+/*
+ * Current position in the savefile, and whether we ran off its end
+ */
+static size_t sf_pos;
+static bool sf_short;
+
+/*
+ * Sections of the last savefile which have not been read yet
+ */
+static sf_section sf_lazy_messages;
+static sf_section sf_lazy_notes;
+static bool sf_want_messages;
+static bool sf_want_notes;
+
+/*
+ * Whether the notes are kept (see "rd_notes()")
+ */
+static bool sf_notes_alive;
 
 /*
  * Hack -- old "encryption" byte
@@ -172,8 +192,16 @@ static byte sf_get(void)
 {
     byte c, v;
 
-    /* Get a character, decode the value */
-    c = getc(fff) & 0xFF;
+    /* Get a character (zero past the end), decode the value */
+    if (sf_pos < sf_size)
+    {
+        c = sf_buf[sf_pos++];
+    }
+    else
+    {
+        c = 0;
+        sf_short = TRUE;
+    }
     v = c ^ xor_byte;
     xor_byte = c;
 
@@ -185,6 +213,16 @@ static byte sf_get(void)
     return (v);
 }
 
+/*
+ * Move to a given byte of the savefile.  Each byte is encoded against
+ * the one before it, so decoding can start anywhere after the header.
+ */
+static void sf_seek(size_t pos)
+{
+    sf_pos = pos;
+    xor_byte = sf_buf[pos - 1];
+}
+
 static void rd_byte(byte* ip) { *ip = sf_get(); }
 
 static void rd_u16b(u16b* ip)
@@ -622,8 +660,12 @@ static void rd_options(void)
     rd_byte(&b);
     op_ptr->hitpoint_warn = b;
 
-    // 8 spare bytes
-    strip_bytes(8);
+    /* Read "frame_budget" (a spare byte in older savefiles) */
+    rd_byte(&b);
+    op_ptr->frame_budget = (b < 10) ? b : 0;
+
+    // 7 spare bytes
+    strip_bytes(7);
 
     /*** Normal Options ***/
 
@@ -1099,7 +1141,7 @@ static errr rd_randarts(void)
  */
 static bool rd_notes(void)
 {
-    int alive = (!p_ptr->is_dead || arg_wizard);
+    int alive = sf_notes_alive;
     char tmpstr[100];
     int i;
 
@@ -1116,7 +1158,7 @@ static bool rd_notes(void)
         {
             rd_string(tmpstr, sizeof(tmpstr));
             /* Found the end? */
-            if (strstr(tmpstr, NOTES_MARK))
+            if (strstr(tmpstr, NOTES_MARK) || sf_short)
                 break;
             my_strcat(
                 notes_buffer, format("%s\n", tmpstr), sizeof(notes_buffer));
@@ -1130,7 +1172,7 @@ static bool rd_notes(void)
             rd_string(tmpstr, sizeof(tmpstr));
 
             /* Found the end? */
-            if (strstr(tmpstr, NOTES_MARK))
+            if (strstr(tmpstr, NOTES_MARK) || sf_short)
             {
                 break;
             }
@@ -1381,6 +1423,12 @@ static errr rd_dungeon(void)
         }
     }
 
+    /* No flows */
+    wipe_flows();
+
+    /* No remembered lines of sight */
+    los_cache_forget();
+
     /*** Player ***/
 
     /* Load depth */
@@ -1550,47 +1598,10 @@ static errr rd_dungeon(void)
 }
 
 /*
- * Actually read the savefile
+ * Read the RNG state and the options
  */
-static errr rd_savefile_new_aux(void)
+static errr rd_sect_options(void)
 {
-    int i;
-
-    byte tmp8u;
-    u16b tmp16u;
-
-    u32b n_x_check, n_v_check;
-    u32b o_x_check, o_v_check;
-
-    /* Mention the savefile version */
-    note(
-        format("Loading a %d.%d.%d savefile...", sf_major, sf_minor, sf_patch));
-
-    /* Strip the version bytes */
-    strip_bytes(4);
-
-    /* Hack -- decrypt */
-    xor_byte = sf_extra;
-
-    /* Clear the checksums */
-    v_check = 0L;
-    x_check = 0L;
-
-    /* Operating system info */
-    rd_u32b(&sf_xtra);
-
-    /* Time of savefile creation */
-    rd_u32b(&sf_when);
-
-    /* Number of resurrections */
-    rd_u16b(&sf_lives);
-
-    /* Number of times played */
-    rd_u16b(&sf_saves);
-
-    // 8 spare bytes
-    strip_bytes(8);
-
     /* Read RNG state */
     rd_randomizer();
     if (arg_fiddle)
@@ -1601,11 +1612,30 @@ static errr rd_savefile_new_aux(void)
     if (arg_fiddle)
         note("Loaded Option Flags");
 
-    /* Then the "messages" */
+    return (0);
+}
+
+/*
+ * Read the message recall
+ */
+static errr rd_sect_messages(void)
+{
     rd_messages();
     if (arg_fiddle)
         note("Loaded Messages");
 
+    return (0);
+}
+
+/*
+ * Read the monster memory
+ */
+static errr rd_sect_lore(void)
+{
+    int i;
+
+    u16b tmp16u;
+
     /* Monster Memory */
     rd_u16b(&tmp16u);
 
@@ -1622,9 +1652,25 @@ static errr rd_savefile_new_aux(void)
         /* Read the lore */
         rd_lore(i);
     }
+
+    /* The cached allocation bands are stale */
+    alloc_race_stamp++;
     if (arg_fiddle)
         note("Loaded Monster Memory");
 
+    return (0);
+}
+
+/*
+ * Read the object memory and the artefacts
+ */
+static errr rd_sect_knowledge(void)
+{
+    int i;
+
+    byte tmp8u;
+    u16b tmp16u;
+
     /* Object Memory */
     rd_u16b(&tmp16u);
 
@@ -1638,8 +1684,6 @@ static errr rd_savefile_new_aux(void)
     /* Read the object memory */
     for (i = 0; i < tmp16u; i++)
     {
-        byte tmp8u;
-
         object_kind* k_ptr = &k_info[i];
 
         rd_byte(&tmp8u);
@@ -1674,6 +1718,14 @@ static errr rd_savefile_new_aux(void)
     if (arg_fiddle)
         note("Loaded Artefacts");
 
+    return (0);
+}
+
+/*
+ * Read the player and the random artefacts
+ */
+static errr rd_sect_player(void)
+{
     /* Read the extra stuff */
     if (rd_extra())
         return (-1);
@@ -1685,11 +1737,30 @@ static errr rd_savefile_new_aux(void)
     if (arg_fiddle)
         note("Loaded Random Artefacts");
 
+    /* Only living characters keep their notes */
+    sf_notes_alive = (!p_ptr->is_dead || arg_wizard);
+
+    return (0);
+}
+
+/*
+ * Read the notes
+ */
+static errr rd_sect_notes(void)
+{
     if (rd_notes())
         return (-1);
     if (arg_fiddle)
         note("Loaded Notes");
 
+    return (0);
+}
+
+/*
+ * Read the inventory
+ */
+static errr rd_sect_inven(void)
+{
     /* Important -- Initialize the race/house */
     rp_ptr = &p_info[p_ptr->prace];
     hp_ptr = &c_info[p_ptr->phouse];
@@ -1701,17 +1772,268 @@ static errr rd_savefile_new_aux(void)
         return (-1);
     }
 
-    /* I'm not dead yet... */
-    if (!p_ptr->is_dead)
+    return (0);
+}
+
+/*
+ * Read the dungeon of a living character
+ */
+static errr rd_sect_dungeon(void)
+{
+    /* Dead players have no dungeon */
+    note("Restoring Dungeon...");
+    if (rd_dungeon())
     {
-        /* Dead players have no dungeon */
-        note("Restoring Dungeon...");
-        if (rd_dungeon())
+        note("Error reading dungeon data");
+        return (-1);
+    }
+
+    return (0);
+}
+
+/*
+ * Read one section of a sectioned savefile, and verify it
+ */
+static errr rd_section_at(const sf_section* s, errr (*reader)(void))
+{
+    /* Go to the section */
+    sf_seek(s->offset);
+
+    /* Clear the checksums */
+    v_check = 0L;
+    x_check = 0L;
+
+    /* Read it */
+    if (reader())
+        return (-1);
+
+    /* Verify */
+    if (sf_short || (sf_pos != s->offset + s->length) || (v_check != s->v_sum)
+        || (x_check != s->x_sum))
+    {
+        note("Invalid checksum in savefile section");
+        return (-1);
+    }
+
+    /* Success */
+    return (0);
+}
+
+/*
+ * Find a section of a sectioned savefile
+ */
+static const sf_section* find_section(
+    const sf_section* toc, int num, u16b type)
+{
+    int i;
+
+    for (i = 0; i < num; i++)
+    {
+        if (toc[i].type == type)
+            return (&toc[i]);
+    }
+
+    note(format("Missing savefile section %u", type));
+    return (NULL);
+}
+
+/*
+ * Read one section of a sectioned savefile, given its type
+ */
+static errr rd_section(
+    const sf_section* toc, int num, u16b type, errr (*reader)(void))
+{
+    const sf_section* s = find_section(toc, num, type);
+
+    if (!s)
+        return (-1);
+
+    return (rd_section_at(s, reader));
+}
+
+/*
+ * Read a sectioned savefile, starting just after the preamble
+ *
+ * The file ends with the section table, the offset of that table, and
+ * the two checksums.  The encoded checksum covers the whole file, so it
+ * is verified up front; each section then carries its own checksums.
+ *
+ * The message recall and the notes of a living character are not read
+ * here, but left for "load_messages()" and "load_notes()".
+ */
+static errr rd_sections(u32b layout)
+{
+    int i, num;
+
+    size_t pos, start = sf_pos;
+
+    u16b tmp16u;
+    u32b toc_offset, x_sum;
+
+    sf_section toc[SF_SECT_MAX];
+    const sf_section* s;
+
+    /* Unknown layout */
+    if (layout > SF_SECTION_VERSION)
+    {
+        note("Savefile sections are from the future");
+        return (-1);
+    }
+
+    /* Room for the table, its offset, and the checksums */
+    if (sf_size < start + 2 + 12)
+        return (-1);
+
+    /* Verify the encoded checksum */
+    for (x_sum = 0L, pos = 4; pos < sf_size - 4; pos++)
+        x_sum += sf_buf[pos];
+    sf_seek(sf_size - 4);
+    rd_u32b(&toc_offset);
+    if (toc_offset != x_sum)
+    {
+        note("Invalid encoded checksum");
+        return (-1);
+    }
+
+    /* Find the section table */
+    sf_seek(sf_size - 12);
+    rd_u32b(&toc_offset);
+    if ((toc_offset < start) || (toc_offset > sf_size - 12 - 2))
+    {
+        note("Invalid savefile section table");
+        return (-1);
+    }
+
+    /* Read the section table */
+    sf_seek(toc_offset);
+    rd_u16b(&tmp16u);
+    if (tmp16u > SF_SECT_MAX)
+    {
+        note(format("Too many (%u) savefile sections!", tmp16u));
+        return (-1);
+    }
+    num = tmp16u;
+
+    for (i = 0; i < num; i++)
+    {
+        rd_u16b(&toc[i].type);
+        rd_u32b(&toc[i].offset);
+        rd_u32b(&toc[i].length);
+        rd_u32b(&toc[i].v_sum);
+        rd_u32b(&toc[i].x_sum);
+
+        /* Sections lie between the preamble and the table */
+        if ((toc[i].offset < start) || (toc[i].offset > toc_offset)
+            || (toc[i].length > toc_offset - toc[i].offset))
         {
-            note("Error reading dungeon data");
+            note("Invalid savefile section table");
             return (-1);
         }
     }
+    if (sf_short || (sf_pos != sf_size - 12))
+    {
+        note("Invalid savefile section table");
+        return (-1);
+    }
+
+    /* Read the sections the game needs now */
+    if (rd_section(toc, num, SF_SECT_OPTIONS, rd_sect_options)
+        || rd_section(toc, num, SF_SECT_LORE, rd_sect_lore)
+        || rd_section(toc, num, SF_SECT_KNOWLEDGE, rd_sect_knowledge)
+        || rd_section(toc, num, SF_SECT_PLAYER, rd_sect_player)
+        || rd_section(toc, num, SF_SECT_INVEN, rd_sect_inven))
+    {
+        return (-1);
+    }
+
+    /* I'm not dead yet... */
+    if (!p_ptr->is_dead
+        && rd_section(toc, num, SF_SECT_DUNGEON, rd_sect_dungeon))
+    {
+        return (-1);
+    }
+
+    /* Leave the messages for later */
+    s = find_section(toc, num, SF_SECT_MESSAGES);
+    if (!s)
+        return (-1);
+    sf_lazy_messages = *s;
+    sf_want_messages = TRUE;
+
+    /* Leave the notes of the living for later */
+    if (sf_notes_alive)
+    {
+        s = find_section(toc, num, SF_SECT_NOTES);
+        if (!s)
+            return (-1);
+        sf_lazy_notes = *s;
+        sf_want_notes = TRUE;
+    }
+
+    /* The dead have no use for them */
+    else
+    {
+        C_WIPE(notes_buffer, NOTES_LENGTH, char);
+    }
+
+    /* Success */
+    return (0);
+}
+
+/*
+ * Actually read the savefile
+ */
+static errr rd_savefile_new_aux(void)
+{
+    u32b n_x_check, n_v_check;
+    u32b o_x_check, o_v_check;
+    u32b spare, layout;
+
+    /* Mention the savefile version */
+    note(
+        format("Loading a %d.%d.%d savefile...", sf_major, sf_minor, sf_patch));
+
+    /* Strip the version bytes */
+    strip_bytes(4);
+
+    /* Hack -- decrypt */
+    xor_byte = sf_extra;
+
+    /* Clear the checksums */
+    v_check = 0L;
+    x_check = 0L;
+
+    /* Operating system info */
+    rd_u32b(&sf_xtra);
+
+    /* Time of savefile creation */
+    rd_u32b(&sf_when);
+
+    /* Number of resurrections */
+    rd_u16b(&sf_lives);
+
+    /* Number of times played */
+    rd_u16b(&sf_saves);
+
+    // 8 spare bytes (which may mark a sectioned savefile)
+    rd_u32b(&spare);
+    rd_u32b(&layout);
+
+    /* Read the savefile a section at a time */
+    if (spare == SF_SECTIONS)
+        return (rd_sections(layout));
+
+    /* Read an old savefile from start to end */
+    if (rd_sect_options() || rd_sect_messages() || rd_sect_lore()
+        || rd_sect_knowledge() || rd_sect_player() || rd_sect_notes()
+        || rd_sect_inven())
+    {
+        return (-1);
+    }
+
+    /* I'm not dead yet... */
+    if (!p_ptr->is_dead && rd_sect_dungeon())
+        return (-1);
 
     /* Save the checksum */
     n_v_check = v_check;
@@ -1739,10 +2061,27 @@ static errr rd_savefile_new_aux(void)
         return (-1);
     }
 
+    /* Ran off the end */
+    if (sf_short)
+        return (-1);
+
     /* Success */
     return (0);
 }
 
+/*
+ * Forget the last savefile, once nothing more is wanted from it
+ */
+static void sf_release(void)
+{
+    if (sf_want_messages || sf_want_notes)
+        return;
+
+    if (sf_buf)
+        KILL(sf_buf);
+    sf_size = 0;
+}
+
 /*
  * Actually read the savefile
  */
@@ -1750,6 +2089,14 @@ static errr rd_savefile(void)
 {
     errr err;
 
+    FILE* fff;
+
+    long size;
+
+    /* Forget any earlier savefile */
+    sf_want_messages = sf_want_notes = FALSE;
+    sf_release();
+
     /* Grab permissions */
     safe_setuid_grab();
 
@@ -1763,20 +2110,66 @@ static errr rd_savefile(void)
     if (!fff)
         return (-1);
 
-    /* Call the sub-function */
-    err = rd_savefile_new_aux();
-
-    /* Check for errors */
-    if (ferror(fff))
-        err = -1;
+    /* Read the whole file */
+    err = -1;
+    if (!fseek(fff, 0L, SEEK_END) && ((size = ftell(fff)) > 4)
+        && !fseek(fff, 0L, SEEK_SET))
+    {
+        sf_size = (size_t)size;
+        C_MAKE(sf_buf, sf_size, byte);
+        if (fread(sf_buf, 1, sf_size, fff) == sf_size)
+            err = 0;
+    }
 
     /* Close the file */
     my_fclose(fff);
 
+    /* Call the sub-function */
+    sf_pos = 0;
+    sf_short = FALSE;
+    if (!err)
+        err = rd_savefile_new_aux();
+
+    /* Forget the file on failure, or if nothing was left for later */
+    if (err)
+        sf_want_messages = sf_want_notes = FALSE;
+    sf_release();
+
     /* Result */
     return (err);
 }
 
+/*
+ * Read the message recall, if it was left in the savefile
+ */
+void load_messages(void)
+{
+    if (!sf_want_messages)
+        return;
+
+    /* Reading the messages adds them, which comes back here */
+    sf_want_messages = FALSE;
+
+    (void)rd_section_at(&sf_lazy_messages, rd_sect_messages);
+
+    sf_release();
+}
+
+/*
+ * Read the notes, if they were left in the savefile
+ */
+void load_notes(void)
+{
+    if (!sf_want_notes)
+        return;
+
+    sf_want_notes = FALSE;
+
+    (void)rd_section_at(&sf_lazy_notes, rd_sect_notes);
+
+    sf_release();
+}
+
 /*
  * Attempt to Load a "savefile"
  *
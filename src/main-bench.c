@@ -0,0 +1,1427 @@
+/* File: main-bench.c */
+
+/*
+ * Copyright (c) 1997 Ben Harrison, and others
+ *
+ * This software may be copied and distributed for educational, research,
+ * and not for profit purposes provided that this copyright and statement
+ * are included in all such copies.
+ */
+
+/*
+ * Headless turn-throughput benchmark ("sil-bench").
+ *
+ * This file has its own "main()" function and is linked against the game
+ * core in place of "main.c" and the visual modules.  The single "term" it
+ * creates draws nothing (compare "main-xxx.c"), and its keypress hook
+ * plays a simple scripted character instead of waiting for the keyboard.
+ *
+ * A character is rolled from a fixed seed, levels are made with
+ * "generate_cave()", and the same sequence of calls that "dungeon()" makes
+ * on every game turn is then repeated for the requested number of turns.
+ * At the end the turn rate, the median and 99th percentile time of a game
+ * turn, and the total time spent in each part of the turn are reported.
+ *
+ * The harness never saves, and it brings the character back to life
+ * (on a new level) whenever it dies, so that every run is the same length.
+ *
+ * With "-b" it instead makes a batch of levels at every depth, spread over
+ * several worker processes, and reports how long they took to make and
+ * what ended up on them.  Each worker is a separate process with its own
+ * copy of the cave and RNG, and every level is made from its own seed
+ * (starting from the same character), so the results do not depend on the
+ * number of workers.
+ *
+ * With "-c" it instead checks level contexts (see "level_context_swap()"):
+ * every level is made twice from the same seed, once in place and once in
+ * a second context, and the two must match, as must the first one once it
+ * is swapped back in.
+ *
+ * With "-f" it instead times the text the game builds most often (the
+ * names of monsters and objects, messages about them, and the status
+ * lines) on the first level, and reports how many of each it can make
+ * in a second.
+ *
+ * With "-t" it instead times parsing the template files in "lib/edit",
+ * the work done at startup whenever the binary image files are stale.
+ */
+
+#include "angband.h"
+
+#include "init.h"
+
+#ifdef USE_BENCH
+
+#include <sys/wait.h>
+
+/*
+ * Parts of the game turn that are timed separately
+ */
+#define BENCH_GENERATE 0
+#define BENCH_PLAYER 1
+#define BENCH_MONSTERS 2
+#define BENCH_WORLD 3
+#define BENCH_UPDATE 4
+#define BENCH_REDRAW 5
+#define BENCH_ENERGY 6
+#define BENCH_MAX 7
+
+static cptr bench_part_name[BENCH_MAX] = { "generate_cave", "process_player",
+    "process_monsters", "process_world", "notice/update", "redraw/window",
+    "energy" };
+
+/*
+ * Accumulated nanoseconds and calls for each part
+ */
+static uint64_t bench_part_time[BENCH_MAX];
+static u32b bench_part_calls[BENCH_MAX];
+
+/*
+ * Start time of the part being timed
+ */
+static uint64_t bench_part_start;
+
+/*
+ * Time taken by each game turn, in nanoseconds
+ */
+static u32b* bench_turn_time;
+
+/*
+ * Private state for the scripted player (kept apart from the game RNG)
+ */
+static u32b bench_script_seed = 1;
+static int bench_script_dir = 0;
+static int bench_script_keys = 0;
+
+/*
+ * Some counters for the report
+ */
+static u32b bench_levels = 0;
+static u32b bench_deaths = 0;
+
+/*
+ * The (only) term
+ */
+static term bench_term;
+
+/*
+ * Read the monotonic clock, in nanoseconds
+ */
+static uint64_t bench_clock(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+}
+
+/*
+ * Start timing a part of the turn
+ */
+static void bench_start(void)
+{
+    bench_part_start = bench_clock();
+}
+
+/*
+ * Stop timing a part of the turn, and charge it to "part"
+ */
+static void bench_stop(int part)
+{
+    bench_part_time[part] += bench_clock() - bench_part_start;
+    bench_part_calls[part]++;
+}
+
+/*
+ * Simple private random number generator for the script
+ */
+static int bench_script_rand(int m)
+{
+    bench_script_seed = bench_script_seed * 1103515245L + 12345L;
+
+    return ((int)((bench_script_seed >> 16) % (u32b)m));
+}
+
+/*
+ * Can the scripted player usefully step in the given direction?
+ */
+static bool bench_script_okay(int dir)
+{
+    int y = p_ptr->py + ddy[dir];
+    int x = p_ptr->px + ddx[dir];
+
+    if (!in_bounds(y, x))
+        return (FALSE);
+
+    /* Doors are opened with the alter command */
+    if (cave_known_closed_door_bold(y, x))
+        return (TRUE);
+
+    /* Avoid walls, chasms and known traps (which ask for confirmation) */
+    if (!cave_floor_bold(y, x))
+        return (FALSE);
+    if (cave_feat[y][x] == FEAT_CHASM)
+        return (FALSE);
+    if (cave_trap_bold(y, x) && !(cave_info[y][x] & (CAVE_HIDDEN)))
+        return (FALSE);
+
+    return (TRUE);
+}
+
+/*
+ * Queue the keys for the next action of the scripted player.
+ *
+ * The script fights any visible adjacent monster, rests when badly hurt,
+ * and otherwise wanders, keeping its heading until it is blocked.  The
+ * same keys also answer any prompt the game happens to be showing.
+ */
+static void bench_script(void)
+{
+    int i, dir;
+
+    /* Break out of anything that keeps asking for keys */
+    if (++bench_script_keys > 100)
+    {
+        bench_script_keys = 0;
+        Term_keypress(ESCAPE);
+        return;
+    }
+
+    /* Fight */
+    for (i = 0; i < 8; i++)
+    {
+        int y = p_ptr->py + ddy_ddd[i];
+        int x = p_ptr->px + ddx_ddd[i];
+        int m_idx = cave_m_idx[y][x];
+
+        if ((m_idx > 0) && mon_list[m_idx].ml)
+        {
+            Term_keypress(';');
+            Term_keypress(I2D(ddd[i]));
+            return;
+        }
+    }
+
+    /* Rest */
+    if ((p_ptr->chp < p_ptr->mhp / 2) && !bench_script_rand(2))
+    {
+        Term_keypress('Z');
+        return;
+    }
+
+    /* Pick a new heading when blocked (or now and then) */
+    dir = bench_script_dir;
+    if (!dir || !bench_script_okay(dir) || !bench_script_rand(20))
+    {
+        dir = 0;
+
+        for (i = 0; i < 16; i++)
+        {
+            int d = ddd[bench_script_rand(8)];
+
+            if (bench_script_okay(d))
+            {
+                dir = d;
+                break;
+            }
+        }
+
+        bench_script_dir = dir;
+    }
+
+    /* Nowhere to go */
+    if (!dir)
+    {
+        Term_keypress('z');
+        return;
+    }
+
+    /* Walk, or open a door */
+    if (cave_known_closed_door_bold(
+            p_ptr->py + ddy[dir], p_ptr->px + ddx[dir]))
+        Term_keypress('/');
+    else
+        Term_keypress(';');
+
+    Term_keypress(I2D(dir));
+}
+
+/*
+ * Handle a "special request" for the null term
+ */
+static errr Term_xtra_bench(int n, int v)
+{
+    switch (n)
+    {
+    case TERM_XTRA_EVENT:
+    {
+        /* Only answer when the game is actually waiting */
+        if (v)
+            bench_script();
+        return (0);
+    }
+
+    case TERM_XTRA_FLUSH:
+    case TERM_XTRA_CLEAR:
+    case TERM_XTRA_SHAPE:
+    case TERM_XTRA_FROSH:
+    case TERM_XTRA_FRESH:
+    case TERM_XTRA_NOISE:
+    case TERM_XTRA_SOUND:
+    case TERM_XTRA_BORED:
+    case TERM_XTRA_REACT:
+    case TERM_XTRA_ALIVE:
+    case TERM_XTRA_LEVEL:
+    case TERM_XTRA_DELAY:
+    {
+        return (0);
+    }
+    }
+
+    /* Unknown or Unhandled action */
+    return (1);
+}
+
+/*
+ * Display a cursor (do nothing)
+ */
+static errr Term_curs_bench(int x, int y)
+{
+    /* Unused parameters */
+    (void)x;
+    (void)y;
+
+    return (0);
+}
+
+/*
+ * Erase some characters (do nothing)
+ */
+static errr Term_wipe_bench(int x, int y, int n)
+{
+    /* Unused parameters */
+    (void)x;
+    (void)y;
+    (void)n;
+
+    return (0);
+}
+
+/*
+ * Draw some text (do nothing)
+ */
+static errr Term_text_bench(int x, int y, int n, byte a, cptr cp)
+{
+    /* Unused parameters */
+    (void)x;
+    (void)y;
+    (void)n;
+    (void)a;
+    (void)cp;
+
+    return (0);
+}
+
+/*
+ * Draw a span of attr/char pairs (do nothing)
+ */
+static errr Term_span_bench(int x, int y, int n, const byte* ap, const char* cp)
+{
+    /* Unused parameters */
+    (void)x;
+    (void)y;
+    (void)n;
+    (void)ap;
+    (void)cp;
+
+    return (0);
+}
+
+/*
+ * Prepare the null term
+ */
+static void init_bench_term(void)
+{
+    term* t = &bench_term;
+
+    /* Initialize the term */
+    term_init(t, 80, 24, 256);
+
+    /* The script never gets bored */
+    t->never_bored = TRUE;
+
+    /* Prepare the hooks */
+    t->xtra_hook = Term_xtra_bench;
+    t->curs_hook = Term_curs_bench;
+    t->wipe_hook = Term_wipe_bench;
+    t->text_hook = Term_text_bench;
+    t->span_hook = Term_span_bench;
+
+    /* Activate it */
+    Term_activate(t);
+
+    /* Save it */
+    term_screen = t;
+    angband_term[0] = t;
+}
+
+/*
+ * Generate a new level, timing it
+ */
+static void bench_generate(void)
+{
+    bench_start();
+    generate_cave();
+    bench_stop(BENCH_GENERATE);
+
+    bench_levels++;
+
+    /* The player is back on the ground */
+    p_ptr->leaving = FALSE;
+    p_ptr->leaping = FALSE;
+    p_ptr->knocked_back = FALSE;
+
+    /* Set up the view, the noise flow and the display (as "dungeon()") */
+    verify_panel();
+    p_ptr->update |= (PU_BONUS | PU_HP | PU_MANA);
+    p_ptr->update |= (PU_FORGET_VIEW | PU_UPDATE_VIEW | PU_DISTANCE);
+    p_ptr->redraw |= (PR_BASIC | PR_EXTRA | PR_MAP);
+    update_stuff();
+    redraw_stuff();
+    update_flow(p_ptr->py, p_ptr->px, FLOW_PLAYER_NOISE);
+}
+
+/*
+ * Bring a dead character back (compare "cheat death" in "play_game()")
+ */
+static void bench_revive(void)
+{
+    bench_deaths++;
+
+    p_ptr->is_dead = FALSE;
+    p_ptr->chp = p_ptr->mhp;
+    p_ptr->chp_frac = 0;
+    p_ptr->csp = p_ptr->msp;
+    p_ptr->csp_frac = 0;
+
+    (void)set_blind(0);
+    (void)set_confused(0);
+    (void)set_poisoned(0);
+    (void)set_afraid(0);
+    (void)set_entranced(0);
+    (void)set_image(0);
+    (void)set_stun(0);
+    (void)set_cut(0);
+    (void)set_food(PY_FOOD_FULL - 1);
+}
+
+/*
+ * Handle the "notice", "update", "redraw" and "window" flags, timing them
+ */
+static void bench_handle_stuff(void)
+{
+    bench_start();
+    if (p_ptr->notice)
+        notice_stuff();
+    if (p_ptr->update)
+        update_stuff();
+    bench_stop(BENCH_UPDATE);
+
+    bench_start();
+    if (p_ptr->redraw)
+        redraw_stuff();
+    if (p_ptr->window)
+        window_stuff();
+    if (fresh_after)
+        Term_fresh();
+    bench_stop(BENCH_REDRAW);
+}
+
+/*
+ * Process a single game turn.
+ *
+ * This follows the main loop of "dungeon()" step by step, so keep the
+ * two in agreement.  Return TRUE if the player is leaving the level.
+ */
+static bool bench_game_turn(void)
+{
+    /* Hack -- Compact the monster and object lists occasionally */
+    if (mon_cnt + 10 > MAX_MONSTERS)
+        compact_monsters(20);
+    if (mon_cnt + 32 < MAX_MONSTERS)
+        compact_monsters(0);
+    if (o_cnt + 32 > z_info->o_max)
+        compact_objects(64);
+    if (o_cnt + 32 < o_max)
+        compact_objects(0);
+
+    /* Can the player move? */
+    while ((p_ptr->energy >= 100) && (!p_ptr->leaving))
+    {
+        /* Process monster with even more energy first */
+        bench_start();
+        process_monsters(p_ptr->energy + 1);
+        bench_stop(BENCH_MONSTERS);
+
+        /* If still alive */
+        if (!p_ptr->leaving)
+        {
+            bench_start();
+            if (p_ptr->update)
+                update_stuff();
+            bench_stop(BENCH_UPDATE);
+
+            bench_start();
+            if (p_ptr->redraw)
+                redraw_stuff();
+            bench_stop(BENCH_REDRAW);
+
+            /* Process the player */
+            bench_script_keys = 0;
+            bench_start();
+            process_player();
+            bench_stop(BENCH_PLAYER);
+        }
+    }
+
+    bench_handle_stuff();
+    if (p_ptr->leaving)
+        return (TRUE);
+
+    /* Process monsters (any that haven't had a chance to move yet) */
+    bench_start();
+    process_monsters(100);
+    bench_stop(BENCH_MONSTERS);
+
+    bench_handle_stuff();
+    if (p_ptr->leaving)
+        return (TRUE);
+
+    /* Process the world */
+    bench_start();
+    process_world();
+    bench_stop(BENCH_WORLD);
+
+    bench_handle_stuff();
+    if (p_ptr->leaving)
+        return (TRUE);
+
+    bench_start();
+
+    /* Give the player some energy */
+    p_ptr->energy += extract_energy[p_ptr->pspeed];
+
+    /* Give energy to all monsters */
+    process_monsters_energy();
+
+    /* Count game turns */
+    turn++;
+
+    bench_stop(BENCH_ENERGY);
+
+    return (FALSE);
+}
+
+/*
+ * Sort helper for the turn times
+ */
+static int bench_cmp_u32b(const void* a, const void* b)
+{
+    u32b x = *(const u32b*)a;
+    u32b y = *(const u32b*)b;
+
+    return ((x > y) - (x < y));
+}
+
+/*
+ * Print the results
+ */
+static void bench_report(u32b turns, uint64_t total)
+{
+    int i;
+    double secs = (double)total / 1e9;
+    u32b los_hits, los_misses, los_resets;
+
+    /* Sort the turn times to find the percentiles */
+    qsort(bench_turn_time, turns, sizeof(u32b), bench_cmp_u32b);
+
+    printf("turns:        %lu\n", (unsigned long)turns);
+    printf("levels:       %lu\n", (unsigned long)bench_levels);
+    printf("deaths:       %lu\n", (unsigned long)bench_deaths);
+    printf("player turns: %lu\n", (unsigned long)playerturn);
+    printf("total time:   %.3f s\n", secs);
+    printf("turns/sec:    %.0f\n", (secs > 0.0) ? turns / secs : 0.0);
+    printf("p50 turn:     %.2f us\n", bench_turn_time[turns / 2] / 1e3);
+    printf("p99 turn:     %.2f us\n",
+        bench_turn_time[(turns * 99) / 100] / 1e3);
+    printf("max turn:     %.2f us\n", bench_turn_time[turns - 1] / 1e3);
+
+    los_cache_stats(&los_hits, &los_misses, &los_resets);
+    printf("los cache:    %lu hits, %lu misses, %lu resets\n",
+        (unsigned long)los_hits, (unsigned long)los_misses,
+        (unsigned long)los_resets);
+    printf("\n%-18s %12s %10s %7s\n", "part", "time (ms)", "calls", "share");
+
+    for (i = 0; i < BENCH_MAX; i++)
+    {
+        printf("%-18s %12.2f %10lu %6.1f%%\n", bench_part_name[i],
+            bench_part_time[i] / 1e6, (unsigned long)bench_part_calls[i],
+            (total > 0) ? 100.0 * bench_part_time[i] / total : 0.0);
+    }
+
+#ifdef ALLOW_PROFILE
+
+    printf("\n%-18s %12s %10s %10s\n", "subsystem", "time (ms)", "calls",
+        "mean (us)");
+
+    for (i = 0; i < PROF_MAX; i++)
+    {
+        printf("%-18s %12.2f %10lu %10.2f\n", prof_name[i],
+            prof_time[i] / 1e3, (unsigned long)prof_calls[i],
+            prof_calls[i] ? prof_time[i] / prof_calls[i] : 0.0);
+    }
+
+#endif /* ALLOW_PROFILE */
+}
+
+/*
+ * Statistics for one level of a batch
+ */
+typedef struct bench_level bench_level;
+
+struct bench_level
+{
+    s16b depth; /* Dungeon level */
+    u16b tries; /* Attempts at "generate_cave()" needed */
+    u16b rooms; /* Rooms (and vaults) */
+    u16b vaults; /* Vaults */
+    u16b monsters; /* Live monsters */
+    u16b objects; /* Live objects */
+    u32b time; /* Time taken, in microseconds */
+};
+
+/*
+ * The character, artefacts, object kinds and monster memory every level
+ * of a batch starts from
+ */
+static player_type bench_player;
+static artefact_type* bench_artefacts;
+static object_kind* bench_kinds;
+static monster_lore* bench_lore;
+
+/*
+ * Make level "k" of a batch of "per_depth" levels per depth
+ */
+static void bench_batch_level(bench_level* lv, int k, int per_depth, u32b seed)
+{
+    int i;
+
+    uint64_t t0;
+
+    /* Forget the previous level */
+    forget_view();
+    wipe_o_list();
+    wipe_mon_list();
+
+    g_vault_name[0] = '\0';
+
+    /* Start from the same character, knowledge and seed every time */
+    COPY(p_ptr, &bench_player, player_type);
+    C_COPY(a_info, bench_artefacts, z_info->art_max, artefact_type);
+    C_COPY(k_info, bench_kinds, z_info->k_max, object_kind);
+    C_COPY(l_list, bench_lore, z_info->r_max, monster_lore);
+    Rand_place = 0;
+    Rand_state_init(seed + (u32b)k * 7919L);
+
+    p_ptr->depth = 1 + k / per_depth;
+
+    t0 = bench_clock();
+    generate_cave();
+    lv->time = (u32b)((bench_clock() - t0) / 1000);
+
+    lv->depth = p_ptr->depth;
+    lv->tries = gen_tries;
+    lv->rooms = gen_rooms;
+    lv->vaults = gen_vaults;
+
+    /* Count what is on the level */
+    lv->monsters = 0;
+    for (i = 1; i < mon_max; i++)
+    {
+        if (mon_list[i].r_idx)
+            lv->monsters++;
+    }
+
+    lv->objects = 0;
+    for (i = 1; i < o_max; i++)
+    {
+        if (o_list[i].k_idx)
+            lv->objects++;
+    }
+}
+
+/*
+ * Make every "workers"-th level of a batch, starting with level "w",
+ * writing the statistics to "fff"
+ */
+static void bench_batch_worker(
+    FILE* fff, int w, int workers, int total, int per_depth, u32b seed)
+{
+    int k;
+
+    bench_level lv;
+
+    for (k = w; k < total; k += workers)
+    {
+        bench_batch_level(&lv, k, per_depth, seed);
+        (void)fwrite(&lv, sizeof(lv), 1, fff);
+    }
+
+    (void)fflush(fff);
+}
+
+/*
+ * Remember the starting point of every level of a batch
+ */
+static void bench_batch_begin(void)
+{
+    COPY(&bench_player, p_ptr, player_type);
+    C_MAKE(bench_artefacts, z_info->art_max, artefact_type);
+    C_COPY(bench_artefacts, a_info, z_info->art_max, artefact_type);
+    C_MAKE(bench_kinds, z_info->k_max, object_kind);
+    C_COPY(bench_kinds, k_info, z_info->k_max, object_kind);
+    C_MAKE(bench_lore, z_info->r_max, monster_lore);
+    C_COPY(bench_lore, l_list, z_info->r_max, monster_lore);
+}
+
+/*
+ * Forget the starting point of the levels of a batch
+ */
+static void bench_batch_end(void)
+{
+    FREE(bench_artefacts);
+    FREE(bench_kinds);
+    FREE(bench_lore);
+}
+
+/*
+ * Add "n" bytes at "p" to the FNV-1a hash "sum"
+ */
+static u32b bench_sum(u32b sum, const void* p, size_t n)
+{
+    const byte* s = (const byte*)p;
+
+    while (n--)
+    {
+        sum ^= *s++;
+        sum *= 16777619UL;
+    }
+
+    return (sum);
+}
+
+/*
+ * Hash everything that belongs to the active level, including the
+ * wandering flows and the monster race counts
+ */
+static u32b bench_level_sum(void)
+{
+    int y, i;
+
+    int hgt = p_ptr->cur_map_hgt;
+    int wid = p_ptr->cur_map_wid;
+
+    u32b sum = 2166136261UL;
+
+    for (y = 0; y < hgt; y++)
+    {
+        sum = bench_sum(sum, cave_info[y], wid * sizeof(u16b));
+        sum = bench_sum(sum, cave_feat[y], wid * sizeof(byte));
+        sum = bench_sum(sum, cave_light[y], wid * sizeof(s16b));
+        sum = bench_sum(sum, cave_o_idx[y], wid * sizeof(s16b));
+        sum = bench_sum(sum, cave_m_idx[y], wid * sizeof(s16b));
+        sum = bench_sum(sum, cave_when[y], wid * sizeof(byte));
+    }
+
+    sum = bench_sum(sum, &o_list[1], (o_max - 1) * sizeof(object_type));
+    sum = bench_sum(sum, &mon_list[1], (mon_max - 1) * sizeof(monster_type));
+
+    for (i = FLOW_WANDERING_HEAD; i <= FLOW_WANDERING_TAIL; i++)
+    {
+        sum = bench_sum(sum, &flow_center_y[i], sizeof(byte));
+        sum = bench_sum(sum, &flow_center_x[i], sizeof(byte));
+        sum = bench_sum(sum, &wandering_pause[i], sizeof(s16b));
+
+        for (y = 0; y < hgt; y++)
+            sum = bench_sum(sum, cave_cost[i][y], wid * sizeof(byte));
+    }
+
+    for (i = 1; i < z_info->r_max; i++)
+        sum = bench_sum(sum, &r_info[i].cur_num, sizeof(byte));
+
+    sum = bench_sum(sum, &p_ptr->depth, sizeof(s16b));
+    sum = bench_sum(sum, &p_ptr->py, sizeof(s16b));
+    sum = bench_sum(sum, &p_ptr->px, sizeof(s16b));
+    sum = bench_sum(sum, &num_repro, sizeof(s16b));
+    sum = bench_sum(sum, &feeling, sizeof(byte));
+    sum = bench_sum(sum, &rating, sizeof(s16b));
+    sum = bench_sum(sum, &good_item_flag, sizeof(bool));
+    sum = bench_sum(sum, g_vault_name, strlen(g_vault_name));
+
+    return (sum);
+}
+
+/*
+ * Rebuild the wandering flows of the active level from their centres
+ *
+ * A level which is swapped in (or loaded) gets its wandering flows rebuilt
+ * like this, and these need not match the ones built while the level was
+ * still being made, so a fresh level is given the same treatment before
+ * it is compared with one that was swapped in.
+ */
+static void bench_level_flows(void)
+{
+    int i;
+
+    for (i = FLOW_WANDERING_HEAD; i <= FLOW_WANDERING_TAIL; i++)
+        update_flow(flow_center_y[i], flow_center_x[i], i);
+}
+
+/*
+ * Check "levels" levels spread over the depths from 1 to "max_depth":
+ * each is made in place, then made again from the same seed in a second
+ * level context, and then swapped back in.  All three must match.
+ */
+static void bench_check(int levels, int max_depth, u32b seed)
+{
+    int k;
+    int bad = 0;
+
+    int per_depth = (levels + max_depth - 1) / max_depth;
+
+    level_context* lc = level_context_make();
+
+    bench_level lv;
+
+    bench_batch_begin();
+
+    for (k = 0; k < levels; k++)
+    {
+        u32b here, there, back;
+        u32b stamp;
+
+        /* Make the level in place */
+        bench_batch_level(&lv, k, per_depth, seed);
+        bench_level_flows();
+        here = bench_level_sum();
+
+        /* Make it again in the other context */
+        level_context_swap(lc);
+        bench_batch_level(&lv, k, per_depth, seed);
+        bench_level_flows();
+        there = bench_level_sum();
+
+        /* Go back to the first one */
+        stamp = alloc_race_stamp;
+        level_context_swap(lc);
+        back = bench_level_sum();
+
+        /* The race counts changed, so the allocation bands must be stale */
+        if (alloc_race_stamp == stamp)
+            back = ~here;
+
+        if ((here != there) || (here != back))
+        {
+            printf("mismatch:     level %d (depth %d): %08lx %08lx %08lx\n", k,
+                lv.depth, (unsigned long)here, (unsigned long)there,
+                (unsigned long)back);
+            bad++;
+        }
+    }
+
+    bench_batch_end();
+
+    level_context_free(lc);
+
+    printf("checked:      %d levels, %d mismatched\n", levels, bad);
+
+    if (bad)
+        quit("Level contexts do not match!");
+}
+
+/*
+ * Make "per_depth" levels at every depth from 1 to "max_depth", with
+ * "workers" processes, and report on them
+ *
+ * The statistics of every level are also written to "csv", if given.
+ */
+static void bench_batch(
+    int per_depth, int max_depth, int workers, u32b seed, cptr csv)
+{
+    int w, k, depth;
+
+    int total = per_depth * max_depth;
+
+    FILE** tmp;
+
+    bench_level* lv;
+
+    uint64_t begin, wall;
+
+    /* Remember the starting point of every level */
+    bench_batch_begin();
+
+    if (workers > total)
+        workers = total;
+
+    C_MAKE(tmp, workers, FILE*);
+    C_MAKE(lv, total, bench_level);
+
+    /* Do not flush the same output from every worker */
+    (void)fflush(stdout);
+
+    begin = bench_clock();
+
+    for (w = 0; w < workers; w++)
+    {
+        pid_t pid;
+
+        tmp[w] = tmpfile();
+        if (!tmp[w])
+            quit("Cannot create a temporary file!");
+
+        /* Without other workers, just do the work here */
+        if (workers == 1)
+        {
+            bench_batch_worker(tmp[w], w, workers, total, per_depth, seed);
+            break;
+        }
+
+        pid = fork();
+
+        if (pid < 0)
+            quit("Cannot start a worker!");
+
+        /* The worker */
+        if (pid == 0)
+        {
+            bench_batch_worker(tmp[w], w, workers, total, per_depth, seed);
+            _exit(0);
+        }
+    }
+
+    /* Wait for the workers */
+    if (workers > 1)
+    {
+        while (wait(NULL) > 0)
+            ;
+    }
+
+    wall = bench_clock() - begin;
+
+    /* Collect the levels, in the order they were handed out */
+    for (w = 0; w < workers; w++)
+    {
+        rewind(tmp[w]);
+
+        for (k = w; k < total; k += workers)
+        {
+            if (fread(&lv[k], sizeof(lv[k]), 1, tmp[w]) != 1)
+                quit("A worker failed!");
+        }
+
+        (void)fclose(tmp[w]);
+    }
+
+    /* Every level */
+    if (csv)
+    {
+        FILE* fff = fopen(csv, "w");
+
+        if (!fff)
+            quit_fmt("Cannot write %s!", csv);
+
+        fprintf(fff, "depth,level,tries,rooms,vaults,monsters,objects,"
+                     "time_us\n");
+
+        for (k = 0; k < total; k++)
+        {
+            fprintf(fff, "%d,%d,%u,%u,%u,%u,%u,%lu\n", lv[k].depth,
+                k % per_depth, lv[k].tries, lv[k].rooms, lv[k].vaults,
+                lv[k].monsters, lv[k].objects, (unsigned long)lv[k].time);
+        }
+
+        (void)fclose(fff);
+    }
+
+    printf("levels:       %d (%d per depth, %d workers)\n", total, per_depth,
+        workers);
+    printf("levels/sec:   %.1f\n", total / (wall / 1e9));
+    printf("\n%5s %7s %7s %7s %9s %8s %10s %10s\n", "depth", "tries",
+        "rooms", "vaults", "monsters", "objects", "mean (ms)", "max (ms)");
+
+    /* Averages for every depth */
+    for (depth = 1; depth <= max_depth; depth++)
+    {
+        double tries = 0, rooms = 0, vaults = 0, mons = 0, objs = 0;
+        double time = 0;
+        u32b most = 0;
+
+        for (k = (depth - 1) * per_depth; k < depth * per_depth; k++)
+        {
+            tries += lv[k].tries;
+            rooms += lv[k].rooms;
+            vaults += lv[k].vaults;
+            mons += lv[k].monsters;
+            objs += lv[k].objects;
+            time += lv[k].time;
+            most = MAX(most, lv[k].time);
+        }
+
+        printf("%5d %7.2f %7.2f %7.2f %9.1f %8.1f %10.2f %10.2f\n", depth,
+            tries / per_depth, rooms / per_depth, vaults / per_depth,
+            mons / per_depth, objs / per_depth, time / per_depth / 1e3,
+            most / 1e3);
+    }
+
+    FREE(lv);
+    FREE(tmp);
+
+    bench_batch_end();
+}
+
+/*
+ * Time "rounds" rounds of parsing each template file (see "init_info()")
+ */
+static void bench_parse(u32b rounds)
+{
+    struct
+    {
+        cptr name;
+        parse_info_txt_func parse;
+        int num;
+        int len;
+        uint64_t time;
+    } file[] = {
+        { "terrain", parse_f_info, z_info->f_max, sizeof(feature_type), 0 },
+        { "object", parse_k_info, z_info->k_max, sizeof(object_kind), 0 },
+        { "ability", parse_b_info, z_info->b_max, sizeof(ability_type), 0 },
+        { "artefact", parse_a_info, z_info->art_max, sizeof(artefact_type),
+            0 },
+        { "special", parse_e_info, z_info->e_max, sizeof(ego_item_type), 0 },
+        { "monster", parse_r_info, z_info->r_max, sizeof(monster_race), 0 },
+        { "vault", parse_v_info, z_info->v_max, sizeof(vault_type), 0 },
+        { "history", parse_h_info, z_info->h_max, sizeof(hist_type), 0 },
+        { "race", parse_p_info, z_info->p_max, sizeof(player_race), 0 },
+        { "house", parse_c_info, z_info->c_max, sizeof(player_house), 0 },
+        { "flavor", parse_flavor_info, z_info->flavor_max,
+            sizeof(flavor_type), 0 },
+        { "names", parse_n_info, 1, sizeof(names_type), 0 },
+    };
+
+    char buf[1024];
+
+    u32b n;
+    uint i;
+
+    uint64_t total = 0;
+
+    for (n = 0; n < rounds; n++)
+    {
+        for (i = 0; i < N_ELEMENTS(file); i++)
+        {
+            header head;
+            FILE* fp;
+            errr err;
+            uint64_t t;
+
+            /* Prepare the header and the "fake" arrays */
+            WIPE(&head, header);
+            head.v_major = VERSION_MAJOR;
+            head.v_minor = VERSION_MINOR;
+            head.v_patch = VERSION_PATCH;
+            head.v_extra = VERSION_EXTRA;
+            head.info_num = file[i].num;
+            head.info_len = file[i].len;
+            head.head_size = sizeof(header);
+            head.info_size = head.info_num * head.info_len;
+            head.parse_info_txt = file[i].parse;
+
+            C_MAKE(head.info_ptr, head.info_size, char);
+            C_MAKE(head.name_ptr, z_info->fake_name_size, char);
+            C_MAKE(head.text_ptr, z_info->fake_text_size, char);
+
+            path_build(buf, sizeof(buf), ANGBAND_DIR_EDIT,
+                format("%s.txt", file[i].name));
+            fp = my_fopen(buf, "r");
+            if (!fp)
+                quit_fmt("Cannot open %s!", buf);
+
+            /* Parse it */
+            t = bench_clock();
+            err = init_info_txt(fp, buf, &head, file[i].parse);
+            file[i].time += bench_clock() - t;
+
+            my_fclose(fp);
+
+            if (err)
+            {
+                quit_fmt("Error %d at line %d of %s.txt!", err, error_line,
+                    file[i].name);
+            }
+
+            FREE(head.info_ptr);
+            FREE(head.name_ptr);
+            FREE(head.text_ptr);
+        }
+    }
+
+    printf("%-18s %12s %7s\n", "template", "mean (ms)", "share");
+
+    for (i = 0; i < N_ELEMENTS(file); i++)
+        total += file[i].time;
+
+    for (i = 0; i < N_ELEMENTS(file); i++)
+    {
+        printf("%-18s %12.3f %6.1f%%\n", file[i].name,
+            file[i].time / 1e6 / rounds,
+            total ? 100.0 * file[i].time / total : 0.0);
+    }
+
+    printf("%-18s %12.3f\n", "all", total / 1e6 / rounds);
+}
+
+/*
+ * Print the rate of "calls" calls taking "time" nanoseconds
+ */
+static void bench_format_report(cptr what, u32b calls, uint64_t time)
+{
+    printf("%-18s %10lu %12.0f/s %8.1f ns\n", what, (unsigned long)calls,
+        time ? calls / (time / 1e9) : 0.0, calls ? (double)time / calls : 0.0);
+}
+
+/*
+ * Time "rounds" rounds of naming every monster and object on the level,
+ * formatting a message about each pair, and redrawing the status lines
+ */
+static void bench_format(u32b rounds)
+{
+    char m_name[80];
+    char o_name[80];
+    char buf[1024];
+
+    u32b n;
+    int i;
+
+    u32b monsters = 0, objects = 0, messages = 0;
+    uint64_t m_time = 0, o_time = 0, msg_time = 0, redraw_time = 0;
+    uint64_t t;
+
+    for (n = 0; n < rounds; n++)
+    {
+        /* Name the monsters */
+        t = bench_clock();
+        for (i = 1; i < mon_max; i++)
+        {
+            if (!mon_list[i].r_idx)
+                continue;
+
+            monster_desc(m_name, sizeof(m_name), &mon_list[i], 0x88);
+            monsters++;
+        }
+        m_time += bench_clock() - t;
+
+        /* Name the objects */
+        t = bench_clock();
+        for (i = 1; i < o_max; i++)
+        {
+            if (!o_list[i].k_idx)
+                continue;
+
+            object_desc(o_name, sizeof(o_name), &o_list[i], TRUE, 3);
+            objects++;
+        }
+        o_time += bench_clock() - t;
+
+        /* Format some messages */
+        t = bench_clock();
+        for (i = 0; i < 64; i++)
+        {
+            (void)strnfmt(buf, sizeof(buf), "%^s picks up %s (%+d).",
+                m_name, o_name, i - 32);
+            messages++;
+        }
+        msg_time += bench_clock() - t;
+
+        /* Redraw the status lines */
+        t = bench_clock();
+        p_ptr->redraw |= (PR_BASIC | PR_EXTRA);
+        redraw_stuff();
+        redraw_time += bench_clock() - t;
+    }
+
+    printf("%-18s %10s %14s %11s\n", "text", "calls", "rate", "mean");
+    bench_format_report("monster_desc", monsters, m_time);
+    bench_format_report("object_desc", objects, o_time);
+    bench_format_report("messages", messages, msg_time);
+    bench_format_report("status redraws", rounds, redraw_time);
+}
+
+/*
+ * Find the path to the "lib" folder (as "init_stuff()" in "main.c")
+ */
+static void bench_init_paths(void)
+{
+    char path[1024];
+    cptr tail = getenv("ANGBAND_PATH");
+
+    my_strcpy(path, tail ? tail : DEFAULT_PATH, sizeof(path));
+
+    /* Hack -- Add a path separator (only if needed) */
+    if (!suffix(path, PATH_SEP))
+        my_strcat(path, PATH_SEP, sizeof(path));
+
+    init_file_paths(path);
+}
+
+/*
+ * Run the benchmark
+ */
+int main(int argc, char* argv[])
+{
+    int i;
+
+    u32b turns = 10000L;
+    u32b seed = 42L;
+    u32b regen = 0L;
+    int depth = 2;
+    int race = 0;
+    int house = 0;
+    int batch = 0;
+    int check = 0;
+    u32b rounds = 0L;
+    u32b parse_rounds = 0L;
+    int max_depth = MORGOTH_DEPTH;
+    int workers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    cptr csv = NULL;
+
+    u32b n;
+    uint64_t begin, total;
+
+    /* Save the "program name" */
+    argv0 = argv[0];
+
+    /* Process the command line arguments */
+    for (i = 1; i < argc; i++)
+    {
+        cptr arg = argv[i];
+
+        if ((arg[0] != '-') || !arg[1] || !arg[2])
+            goto usage;
+
+        switch (arg[1])
+        {
+        case 'n':
+            turns = (u32b)atol(arg + 2);
+            break;
+        case 's':
+            seed = (u32b)atol(arg + 2);
+            break;
+        case 'l':
+            depth = atoi(arg + 2);
+            break;
+        case 'g':
+            regen = (u32b)atol(arg + 2);
+            break;
+        case 'r':
+            race = atoi(arg + 2);
+            break;
+        case 'h':
+            house = atoi(arg + 2);
+            break;
+        case 'b':
+            batch = atoi(arg + 2);
+            break;
+        case 'c':
+            check = atoi(arg + 2);
+            break;
+        case 'm':
+            max_depth = atoi(arg + 2);
+            break;
+        case 'j':
+            workers = atoi(arg + 2);
+            break;
+        case 'o':
+            csv = arg + 2;
+            break;
+        case 'f':
+            rounds = (u32b)atol(arg + 2);
+            break;
+        case 't':
+            parse_rounds = (u32b)atol(arg + 2);
+            break;
+        default:
+        usage:
+            puts("Usage: sil-bench [options]");
+            puts("  -n<num>  Run <num> game turns (default 10000)");
+            puts("  -s<num>  Use <num> as the random seed (default 42)");
+            puts("  -l<num>  Start on dungeon level <num> (default 2)");
+            puts("  -g<num>  New level every <num> turns (default never)");
+            puts("  -r<num>  Play race number <num> (default 0)");
+            puts("  -h<num>  Play house number <num> (default 0)");
+            puts("  -b<num>  Just make <num> levels at every depth");
+            puts("  -c<num>  Just check <num> levels made in a second context");
+            puts("  -m<num>  Deepest level for -b and -c (default 20)");
+            puts("  -j<num>  Worker processes for -b (default all cores)");
+            puts("  -o<file> Write the statistics of every level to <file>");
+            puts("  -f<num>  Just time <num> rounds of text formatting");
+            puts("  -t<num>  Just time <num> rounds of template parsing");
+            quit(NULL);
+        }
+    }
+
+    if (turns < 1)
+        turns = 1;
+    if ((depth < 1) || (depth >= MORGOTH_DEPTH))
+        depth = 2;
+    if ((max_depth < 1) || (max_depth > MORGOTH_DEPTH))
+        max_depth = MORGOTH_DEPTH;
+    if (workers < 1)
+        workers = 1;
+
+    /* Get the file paths */
+    bench_init_paths();
+
+    /* Prepare the null term */
+    init_bench_term();
+
+    /* Initialize */
+    init_angband();
+
+    /* Report the template files which had to be parsed */
+    for (i = 0; i < parse_num; i++)
+    {
+        printf("parsed:       %s.txt in %.2f ms\n", parse_file[i],
+            parse_time[i]);
+    }
+
+    /* Just time the template files */
+    if (parse_rounds > 0)
+    {
+        bench_parse(parse_rounds);
+
+        cleanup_angband();
+        quit(NULL);
+    }
+
+    /* Quiet and non-interactive */
+    auto_more = TRUE;
+
+    /* Seed the complex RNG */
+    Rand_quick = FALSE;
+    Rand_state_init(seed);
+    bench_script_seed = seed;
+
+    /* Hack -- seed for flavors and random artefacts */
+    seed_flavor = rand_int(0x10000000);
+    seed_randart = rand_int(0x10000000);
+
+    /* Roll up a character */
+    my_strcpy(op_ptr->full_name, "Bench", sizeof(op_ptr->full_name));
+    player_birth_quick(race, house);
+    process_player_name(FALSE);
+
+    /* Flavor the objects */
+    flavor_init();
+
+    /* Hack -- enter the world (skipping the entry poetry) */
+    turn = 1;
+    playerturn = 1;
+    p_ptr->depth = depth;
+    p_ptr->max_depth = depth;
+    monster_level = object_level = depth;
+
+    /* Just check level contexts */
+    if (check > 0)
+    {
+        bench_check(check, max_depth, seed);
+
+        cleanup_angband();
+        quit(NULL);
+    }
+
+    /* Just make levels */
+    if (batch > 0)
+    {
+        bench_batch(batch, max_depth, workers, seed, csv);
+
+        cleanup_angband();
+        quit(NULL);
+    }
+
+    /* Generate the first level */
+    bench_generate();
+
+    character_generated = TRUE;
+    object_generation_mode = OB_GEN_MODE_NORMAL;
+    p_ptr->playing = TRUE;
+
+    /* Just time the text */
+    if (rounds > 0)
+    {
+        bench_format(rounds);
+
+        cleanup_angband();
+        quit(NULL);
+    }
+
+    /* Room for the turn times */
+    C_MAKE(bench_turn_time, turns, u32b);
+
+    begin = bench_clock();
+
+    for (n = 0; n < turns; n++)
+    {
+        uint64_t t0 = bench_clock();
+        bool leaving = bench_game_turn();
+
+        bench_turn_time[n] = (u32b)(bench_clock() - t0);
+
+        /* Handle death */
+        if (p_ptr->is_dead)
+        {
+            bench_revive();
+            leaving = TRUE;
+        }
+
+        /* Make a new level when leaving, or on request */
+        if (leaving || (regen && !((n + 1) % regen)))
+        {
+            /* Forget the old level */
+            forget_view();
+            wipe_o_list();
+            wipe_mon_list();
+
+            p_ptr->depth = depth;
+            bench_generate();
+        }
+    }
+
+    total = bench_clock() - begin;
+
+    bench_report(turns, total);
+
+    FREE(bench_turn_time);
+
+    /* Free resources */
+    cleanup_angband();
+
+    /* Quit */
+    quit(NULL);
+
+    /* Exit */
+    return (0);
+}
+
+#endif /* USE_BENCH */
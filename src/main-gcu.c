@@ -826,6 +826,52 @@ static errr Term_wipe_gcu(int x, int y, int n)
     return (0);
 }
 
+/*
+ * Draw one character at the cursor
+ */
+static void Term_char_gcu(term_data* td, char c)
+{
+#ifdef USE_GRAPHICS
+    int pic;
+
+    /* Special character */
+    if (use_graphics && (c & 0x80))
+    {
+        /* Determine picture to use */
+        switch (c & 0x7F)
+        {
+#ifdef ACS_CKBOARD
+        /* Wall */
+        case '#':
+            pic = ACS_CKBOARD;
+            break;
+#endif /* ACS_CKBOARD */
+
+#ifdef ACS_CKBOARD
+        /* Mineral vein */
+        case '%':
+            pic = ACS_CKBOARD;
+            break;
+#endif /* ACS_BOARD */
+
+        /* XXX */
+        default:
+            pic = '?';
+            break;
+        }
+
+        /* Draw the picture */
+        waddch(td->win, pic);
+
+        /* Done */
+        return;
+    }
+#endif /* USE_GRAPHICS */
+
+    /* Draw a normal character */
+    waddch(td->win, (byte)c);
+}
+
 /*
  * Place some text on the screen using an attribute
  */
@@ -846,46 +892,51 @@ static errr Term_text_gcu(int x, int y, int n, byte a, cptr s)
 
     /* Draw each character */
     for (i = 0; i < n; i++)
-    {
-#ifdef USE_GRAPHICS
-        int pic;
+        Term_char_gcu(td, s[i]);
 
-        /* Special character */
-        if (use_graphics && (s[i] & 0x80))
-        {
-            /* Determine picture to use */
-            switch (s[i] & 0x7F)
-            {
-#ifdef ACS_CKBOARD
-            /* Wall */
-            case '#':
-                pic = ACS_CKBOARD;
-                break;
-#endif /* ACS_CKBOARD */
+    /* Success */
+    return (0);
+}
 
-#ifdef ACS_CKBOARD
-            /* Mineral vein */
-            case '%':
-                pic = ACS_CKBOARD;
-                break;
-#endif /* ACS_BOARD */
+/*
+ * Place a span of attr/char pairs on the screen (see "Term->span_hook")
+ *
+ * The colour is only changed when the attr does.
+ */
+static errr Term_span_gcu(int x, int y, int n, const byte* ap, const char* cp)
+{
+    term_data* td = (term_data*)(Term->data);
 
-            /* XXX */
-            default:
-                pic = '?';
-                break;
-            }
+    int i;
 
-            /* Draw the picture */
-            waddch(td->win, pic);
+#ifdef A_COLOR
+    /* No colour yet */
+    int fa = -1;
+#endif
+
+    /* Move the cursor */
+    wmove(td->win, y, x);
 
-            /* Next character */
+    /* Draw each grid */
+    for (i = 0; i < n; i++)
+    {
+        /* Black grids are erased */
+        if (!ap[i] && !Term->always_text)
+        {
+            waddch(td->win, ' ');
             continue;
         }
-#endif /* USE_GRAPHICS */
 
-        /* Draw a normal character */
-        waddch(td->win, (byte)s[i]);
+#ifdef A_COLOR
+        /* Set the color */
+        if (can_use_color && (fa != ap[i]))
+        {
+            fa = ap[i];
+            wattrset(td->win, colortable[fa & 0x0F]);
+        }
+#endif
+
+        Term_char_gcu(td, cp[i]);
     }
 
     /* Success */
@@ -927,6 +978,7 @@ static errr term_data_init_gcu(term_data* td, int rows, int cols, int y, int x)
 
     /* Set some more hooks */
     t->text_hook = Term_text_gcu;
+    t->span_hook = Term_span_gcu;
     t->wipe_hook = Term_wipe_gcu;
     t->curs_hook = Term_curs_gcu;
     t->xtra_hook = Term_xtra_gcu;
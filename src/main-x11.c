@@ -103,6 +103,11 @@
 #include <X11/keysym.h>
 #include <X11/keysymdef.h>
 #include <X11/Xatom.h>
+#ifdef USE_X11_THREAD
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdatomic.h>
+#endif /* USE_X11_THREAD */
 #endif /* __MAKEDEPEND__ */
 
 /*
@@ -1340,6 +1345,27 @@ static byte color_table[256][4];
  */
 typedef struct term_data term_data;
 
+#ifdef USE_GRAPHICS
+
+/*
+ * The tile cache is a set-associative cache of server-side pixmaps, each
+ * holding one tile as drawn (a plain tile, or a tile composited over its
+ * terrain), so that drawing it again is a single XCopyArea().
+ */
+#define X11_TILE_SETS 256 /* Number of sets (a power of two) */
+#define X11_TILE_WAYS 4 /* Pixmaps per set */
+
+typedef struct x11_tile x11_tile;
+
+struct x11_tile
+{
+    u32b key; /* Tile/terrain/icons drawn (zero if unused) */
+    u32b used; /* When it was last drawn (for LRU) */
+    Pixmap pix; /* The pixmap */
+};
+
+#endif /* USE_GRAPHICS */
+
 /*
  * A structure for each "term"
  */
@@ -1360,6 +1386,10 @@ struct term_data
 
     /* Color value that is treated as transparent in compositing. */
     unsigned long blank;
+
+    /* Cache of drawn tiles (see above) */
+    x11_tile* tile_cache;
+    u32b tile_clock;
 #endif /* USE_GRAPHICS */
 };
 
@@ -1403,6 +1433,235 @@ struct x11_selection_type
 
 static x11_selection_type x11_selection[1];
 
+#ifdef USE_X11_THREAD
+
+/*
+ * Off-thread rendering
+ *
+ * With "USE_X11_THREAD", the term hooks do not draw anything.  They only
+ * record what "Term_fresh()" asked for into the "back" frame, which is a
+ * list of drawing commands (plus the chars and attrs they use).  At the
+ * end of each refresh the back frame is handed to a render thread, which
+ * replays it with the usual drawing code and flushes the display.  The
+ * handoff is a single-producer/single-consumer pair of frames: the game
+ * swaps its back frame with the render thread's front frame whenever the
+ * front one has been drawn, and otherwise keeps adding to the back frame,
+ * so nothing is ever lost and a slow X server never blocks a refresh.
+ *
+ * Xlib and the "Infowin"/"Infofnt"/"Infoclr" globals are shared by both
+ * threads, so they are only used while holding "x11_mutex" (which is
+ * recursive, as event handling may activate other terms).  Events are
+ * still read, and keypresses still delivered, in the game thread.
+ */
+
+/*
+ * Drawing commands
+ */
+#define X11_CMD_TEXT 1 /* Draw "n" chars in attr "a" */
+#define X11_CMD_WIPE 2 /* Erase "n" grids */
+#define X11_CMD_PICT 3 /* Draw "n" attr/char pairs (and terrain) */
+#define X11_CMD_CURS 4 /* Draw the cursor */
+#define X11_CMD_BIGCURS 5 /* Draw the double width cursor */
+#define X11_CMD_CLEAR 6 /* Clear the window */
+#define X11_CMD_MARK 7 /* Draw the selection box from (x,y) to (w,h) */
+
+typedef struct x11_cmd x11_cmd;
+
+struct x11_cmd
+{
+    term_data* td; /* Window to draw in */
+
+    byte op; /* Command (see above) */
+    byte a; /* Attr */
+
+    s16b x, y; /* Position */
+    s16b w, h; /* Other corner (selection box) */
+    s16b n; /* Number of grids */
+
+    u32b data; /* Offset of the chars/attrs in the frame data */
+};
+
+typedef struct x11_frame x11_frame;
+
+struct x11_frame
+{
+    x11_cmd* cmd; /* Commands */
+    u32b cmd_num;
+    u32b cmd_max;
+
+    char* data; /* Chars and attrs used by the commands */
+    u32b data_num;
+    u32b data_max;
+};
+
+/*
+ * Past this many commands, wait for the render thread to catch up
+ */
+#define X11_CMD_BACKLOG 65536
+
+/*
+ * The two frames, the game's (back) and the render thread's (front)
+ */
+static x11_frame x11_frames[2];
+static x11_frame* x11_back = &x11_frames[0];
+static x11_frame* x11_front = &x11_frames[1];
+
+/*
+ * The front frame is waiting to be drawn
+ */
+static atomic_int x11_front_full;
+
+/*
+ * Wakes the render thread
+ */
+static sem_t x11_wake;
+
+/*
+ * Guards Xlib and the "Info*" globals
+ */
+static pthread_mutex_t x11_mutex;
+
+/*
+ * The render thread is running
+ */
+static bool x11_threaded = FALSE;
+
+/*
+ * How many times the game thread holds "x11_mutex"
+ */
+static int x11_held = 0;
+
+/*
+ * Take and release "x11_mutex" (in the game thread)
+ */
+static void x11_lock(void)
+{
+    if (x11_threaded)
+    {
+        (void)pthread_mutex_lock(&x11_mutex);
+        x11_held++;
+    }
+}
+
+static void x11_unlock(void)
+{
+    if (x11_threaded)
+    {
+        x11_held--;
+        (void)pthread_mutex_unlock(&x11_mutex);
+    }
+}
+
+/*
+ * The data of a command in the back frame
+ */
+#define X11_CMD_DATA(C) (x11_back->data + (C)->data)
+
+/*
+ * Add a command to the back frame, with room for "len" bytes of data
+ */
+static x11_cmd* x11_record(term_data* td, byte op, byte a, int x, int y, int n,
+    u32b len)
+{
+    x11_frame* f = x11_back;
+    x11_cmd* cmd;
+
+    /* Grow the commands */
+    if (f->cmd_num == f->cmd_max)
+    {
+        x11_cmd* old = f->cmd;
+
+        f->cmd_max = f->cmd_max ? 2 * f->cmd_max : 1024;
+        C_MAKE(f->cmd, f->cmd_max, x11_cmd);
+        if (old)
+        {
+            C_COPY(f->cmd, old, f->cmd_num, x11_cmd);
+            FREE(old);
+        }
+    }
+
+    /* Grow the data */
+    if (f->data_num + len > f->data_max)
+    {
+        char* old = f->data;
+
+        while (f->data_num + len > f->data_max)
+            f->data_max = f->data_max ? 2 * f->data_max : 16384;
+        C_MAKE(f->data, f->data_max, char);
+        if (old)
+        {
+            C_COPY(f->data, old, f->data_num, char);
+            FREE(old);
+        }
+    }
+
+    cmd = &f->cmd[f->cmd_num++];
+
+    cmd->td = td;
+    cmd->op = op;
+    cmd->a = a;
+    cmd->x = x;
+    cmd->y = y;
+    cmd->w = cmd->h = 0;
+    cmd->n = n;
+    cmd->data = f->data_num;
+
+    f->data_num += len;
+
+    return (cmd);
+}
+
+/*
+ * Hand the back frame to the render thread, if it is free (or always,
+ * waiting for it, if "wait" is set)
+ *
+ * The render thread needs "x11_mutex" to finish a frame, so there is no
+ * waiting while the game thread holds it (as when an event causes a
+ * redraw); the back frame just keeps growing until the next refresh.
+ */
+static void x11_publish(bool wait)
+{
+    x11_frame* f;
+
+    /* Nothing to draw */
+    if (!x11_back->cmd_num)
+        return;
+
+    /* Waiting now would deadlock */
+    if (x11_held)
+        wait = FALSE;
+
+    /* The render thread is still busy */
+    while (atomic_load_explicit(&x11_front_full, memory_order_acquire))
+    {
+        /* Keep adding to the back frame */
+        if (!wait)
+            return;
+
+        usleep(1000);
+    }
+
+    /* Swap the frames */
+    f = x11_front;
+    x11_front = x11_back;
+    x11_back = f;
+
+    /* Start a new back frame */
+    x11_back->cmd_num = 0;
+    x11_back->data_num = 0;
+
+    /* Wake the render thread */
+    atomic_store_explicit(&x11_front_full, 1, memory_order_release);
+    (void)sem_post(&x11_wake);
+}
+
+#else /* USE_X11_THREAD */
+
+#define x11_lock() ((void)0)
+#define x11_unlock() ((void)0)
+
+#endif /* USE_X11_THREAD */
+
 /*
  * Process a keypress event
  *
@@ -1552,6 +1811,19 @@ static void mark_selection_clear(int x1, int y1, int x2, int y2)
  */
 static void mark_selection_mark(int x1, int y1, int x2, int y2)
 {
+#ifdef USE_X11_THREAD
+    /* Draw it in order with the rest */
+    if (x11_threaded)
+    {
+        x11_cmd* cmd = x11_record(
+            (term_data*)(Term->data), X11_CMD_MARK, 0, x1, y1, 0, 0);
+
+        cmd->w = x2;
+        cmd->h = y2;
+        return;
+    }
+#endif /* USE_X11_THREAD */
+
     square_to_pixel(&x1, &y1, x1, y1);
     square_to_pixel(&x2, &y2, x2, y2);
     XDrawRectangle(Metadpy->dpy, Infowin->win, clr[2]->gc, x1, y1,
@@ -1803,17 +2075,32 @@ static errr CheckEvent(bool wait)
     int i;
     int window = 0;
 
+    x11_lock();
+
     /* Do not wait unless requested */
     if (!wait && !XPending(Metadpy->dpy))
+    {
+        x11_unlock();
         return (1);
+    }
 
     /* Wait in 0.02s increments while updating animations every 0.2s */
     i = 0;
     while (!XPending(Metadpy->dpy))
     {
+        x11_unlock();
+
+#ifdef USE_X11_THREAD
+        /* Hand over anything still waiting to be drawn */
+        if (x11_threaded)
+            x11_publish(FALSE);
+#endif /* USE_X11_THREAD */
+
         // if (i == 0) idle_update();
         usleep(20000);
         i = (i + 1) % 10;
+
+        x11_lock();
     }
 
     /*
@@ -1831,6 +2118,7 @@ static errr CheckEvent(bool wait)
     if (xev->type == MappingNotify)
     {
         XRefreshKeyboardMapping(&xev->xmapping);
+        x11_unlock();
         return 0;
     }
 
@@ -1848,13 +2136,17 @@ static errr CheckEvent(bool wait)
 
     /* Unknown window */
     if (!td || !iwin)
+    {
+        x11_unlock();
         return (0);
+    }
 
     /* Hack -- activate the Term */
     Term_activate(&td->t);
 
-    /* Hack -- activate the window */
+    /* Hack -- activate the window (and font) */
     Infowin_set(iwin);
+    Infofnt_set(td->fnt);
 
     /* Switch on the Type */
     switch (xev->type)
@@ -2021,8 +2313,11 @@ static errr CheckEvent(bool wait)
     /* Hack -- Activate the old term */
     Term_activate(&old_td->t);
 
-    /* Hack -- Activate the proper window */
+    /* Hack -- Activate the proper window (and font) */
     Infowin_set(old_td->win);
+    Infofnt_set(old_td->fnt);
+
+    x11_unlock();
 
     /* Success */
     return (0);
@@ -2099,11 +2394,21 @@ static errr Term_xtra_x11(int n, int v)
     {
     /* Make a noise */
     case TERM_XTRA_NOISE:
+        x11_lock();
         Metadpy_do_beep();
+        x11_unlock();
         return (0);
 
     /* Flush the output XXX XXX */
     case TERM_XTRA_FRESH:
+#ifdef USE_X11_THREAD
+        /* Hand the frame to the render thread */
+        if (x11_threaded)
+        {
+            x11_publish(x11_back->cmd_num > X11_CMD_BACKLOG);
+            return (0);
+        }
+#endif /* USE_X11_THREAD */
         Metadpy_update(1, 0, 0);
         return (0);
 
@@ -2123,23 +2428,48 @@ static errr Term_xtra_x11(int n, int v)
 
     /* Handle change in the "level" */
     case TERM_XTRA_LEVEL:
+#ifdef USE_X11_THREAD
+        /* The render thread uses the window of each command */
+        if (x11_threaded)
+            return (0);
+#endif /* USE_X11_THREAD */
         return (Term_xtra_x11_level(v));
 
     /* Clear the screen and redraw any selection later */
     case TERM_XTRA_CLEAR:
-        Infowin_wipe();
+#ifdef USE_X11_THREAD
+        if (x11_threaded)
+        {
+            (void)x11_record(
+                (term_data*)(Term->data), X11_CMD_CLEAR, 0, 0, 0, 0, 0);
+        }
+        else
+#endif /* USE_X11_THREAD */
+            Infowin_wipe();
         x11_selection->drawn = FALSE;
         return (0);
 
     /* Delay for some milliseconds */
     case TERM_XTRA_DELAY:
+#ifdef USE_X11_THREAD
+        /* Hand over anything still waiting to be drawn */
+        if (x11_threaded)
+            x11_publish(FALSE);
+#endif /* USE_X11_THREAD */
         if (v > 0)
             usleep(1000 * v);
         return (0);
 
     /* React to changes */
     case TERM_XTRA_REACT:
-        return (Term_xtra_x11_react());
+    {
+        errr err;
+
+        x11_lock();
+        err = Term_xtra_x11_react();
+        x11_unlock();
+        return (err);
+    }
     }
 
     /* Unknown */
@@ -2151,6 +2481,15 @@ static errr Term_xtra_x11(int n, int v)
  */
 static errr Term_curs_x11(int x, int y)
 {
+#ifdef USE_X11_THREAD
+    if (x11_threaded)
+    {
+        (void)x11_record(
+            (term_data*)(Term->data), X11_CMD_CURS, 0, x, y, 1, 0);
+        return (0);
+    }
+#endif /* USE_X11_THREAD */
+
     // Sil-y: changed to blue from xor
     XDrawRectangle(Metadpy->dpy, Infowin->win, clr[TERM_BLUE]->gc,
         x * Infofnt->wid + Infowin->ox, y * Infofnt->hgt + Infowin->oy,
@@ -2165,6 +2504,15 @@ static errr Term_curs_x11(int x, int y)
  */
 static errr Term_bigcurs_x11(int x, int y)
 {
+#ifdef USE_X11_THREAD
+    if (x11_threaded)
+    {
+        (void)x11_record(
+            (term_data*)(Term->data), X11_CMD_BIGCURS, 0, x, y, 2, 0);
+        return (0);
+    }
+#endif /* USE_X11_THREAD */
+
     // Sil-y: changed to blue from xor
     XDrawRectangle(Metadpy->dpy, Infowin->win, clr[TERM_BLUE]->gc,
         x * Infofnt->wid + Infowin->ox, y * Infofnt->hgt + Infowin->oy,
@@ -2179,6 +2527,16 @@ static errr Term_bigcurs_x11(int x, int y)
  */
 static errr Term_wipe_x11(int x, int y, int n)
 {
+#ifdef USE_X11_THREAD
+    if (x11_threaded)
+    {
+        (void)x11_record(
+            (term_data*)(Term->data), X11_CMD_WIPE, 0, x, y, n, 0);
+        x11_selection->drawn = FALSE;
+        return (0);
+    }
+#endif /* USE_X11_THREAD */
+
     /* Erase (use black) */
     Infoclr_set(clr[TERM_DARK]);
 
@@ -2197,6 +2555,18 @@ static errr Term_wipe_x11(int x, int y, int n)
  */
 static errr Term_text_x11(int x, int y, int n, byte a, cptr s)
 {
+#ifdef USE_X11_THREAD
+    if (x11_threaded)
+    {
+        x11_cmd* cmd = x11_record(
+            (term_data*)(Term->data), X11_CMD_TEXT, a, x, y, n, n);
+
+        C_COPY(X11_CMD_DATA(cmd), s, n, char);
+        x11_selection->drawn = FALSE;
+        return (0);
+    }
+#endif /* USE_X11_THREAD */
+
     /* Draw the text */
     Infoclr_set(clr[a]);
 
@@ -2260,10 +2630,67 @@ void composite_image(
 }
 
 /*
- * Draw some graphical characters.
+ * Look for a tile in the cache, returning it, or else the least recently
+ * used tile of its set (which the caller must then fill)
  */
-static errr Term_pict_x11(int x, int y, int n, const byte* ap, const char* cp,
-    const byte* tap, const char* tcp)
+static x11_tile* x11_tile_find(term_data* td, u32b key)
+{
+    x11_tile* set;
+    x11_tile* tile;
+
+    int i;
+
+    /* Pick the set (multiplicative hash) */
+    set = &td->tile_cache[(((key * 2654435761UL) & 0xFFFFFFFFUL) >> 24)
+        % (X11_TILE_SETS) * (X11_TILE_WAYS)];
+
+    /* Look for the tile, remembering the least recently used one */
+    tile = &set[0];
+    for (i = 0; i < X11_TILE_WAYS; i++)
+    {
+        if (set[i].key == key)
+        {
+            tile = &set[i];
+            break;
+        }
+
+        if (set[i].used < tile->used)
+            tile = &set[i];
+    }
+
+    tile->used = ++td->tile_clock;
+
+    return (tile);
+}
+
+/*
+ * Fill a cached tile from part of "src" (the tiles, or the composited
+ * tile in "td->TmpImage")
+ */
+static void x11_tile_fill(
+    term_data* td, x11_tile* tile, u32b key, XImage* src, int sx, int sy)
+{
+    Display* dpy = Metadpy->dpy;
+
+    /* Make the pixmap the first time */
+    if (!tile->pix)
+    {
+        tile->pix = XCreatePixmap(dpy, td->win->win, td->fnt->twid,
+            td->fnt->hgt, DefaultDepth(dpy, DefaultScreen(dpy)));
+    }
+
+    /* Draw the tile into it */
+    XPutImage(dpy, tile->pix, clr[0]->gc, src, sx, sy, 0, 0, td->fnt->twid,
+        td->fnt->hgt);
+
+    tile->key = key;
+}
+
+/*
+ * Draw some graphical characters in the window of "td"
+ */
+static void x11_pict(term_data* td, int x, int y, int n, const byte* ap,
+    const char* cp, const byte* tap, const char* tcp)
 {
     int i;
     int x1 = 0, y1 = 0;
@@ -2276,7 +2703,7 @@ static errr Term_pict_x11(int x, int y, int n, const byte* ap, const char* cp,
 
     int x2, y2;
 
-    term_data* td = (term_data*)(Term->data);
+    x11_tile* tile;
 
     y *= Infofnt->hgt;
     x *= Infofnt->wid;
@@ -2308,21 +2735,60 @@ static errr Term_pict_x11(int x, int y, int n, const byte* ap, const char* cp,
         if (((x1 == x2) && (y1 == y2))
             || !(((byte)ta & 0x80) && ((byte)tc & 0x80)))
         {
-            /* Draw object / terrain */
-            XPutImage(Metadpy->dpy, td->win->win, clr[0]->gc, td->tiles, x1, y1,
-                x, y, td->fnt->twid, td->fnt->hgt);
+            /* Draw object / terrain (cached as its own terrain) */
+            u32b key = (c & 0x3F) | ((a & 0x3F) << 6) | ((c & 0x3F) << 12)
+                | ((a & 0x3F) << 18) | (1UL << 26);
+
+            tile = x11_tile_find(td, key);
+            if (tile->key != key)
+                x11_tile_fill(td, tile, key, td->tiles, x1, y1);
         }
         else
         {
-            composite_image(td, x1, y1, x2, y2, alert, glow);
+            u32b key = (c & 0x3F) | ((a & 0x3F) << 6) | ((tc & 0x3F) << 12)
+                | ((ta & 0x3F) << 18) | (alert ? (1UL << 24) : 0)
+                | (glow ? (1UL << 25) : 0) | (1UL << 26);
 
-            /* Draw to screen */
-            XPutImage(Metadpy->dpy, td->win->win, clr[0]->gc, td->TmpImage, 0,
-                0, x, y, td->fnt->twid, td->fnt->hgt);
+            /* Only composite the tiles the first time */
+            tile = x11_tile_find(td, key);
+            if (tile->key != key)
+            {
+                composite_image(td, x1, y1, x2, y2, alert, glow);
+                x11_tile_fill(td, tile, key, td->TmpImage, 0, 0);
+            }
         }
 
+        /* Draw to screen */
+        XCopyArea(Metadpy->dpy, tile->pix, td->win->win, clr[0]->gc, 0, 0,
+            td->fnt->twid, td->fnt->hgt, x, y);
+
         x += td->fnt->wid;
     }
+}
+
+/*
+ * Draw some graphical characters.
+ */
+static errr Term_pict_x11(int x, int y, int n, const byte* ap, const char* cp,
+    const byte* tap, const char* tcp)
+{
+    term_data* td = (term_data*)(Term->data);
+
+#ifdef USE_X11_THREAD
+    if (x11_threaded)
+    {
+        x11_cmd* cmd = x11_record(td, X11_CMD_PICT, 0, x, y, n, 4 * n);
+        char* s = X11_CMD_DATA(cmd);
+
+        /* Keep the attrs, chars, terrain attrs and terrain chars */
+        C_COPY(s, ap, n, byte);
+        C_COPY(s + n, cp, n, char);
+        C_COPY(s + 2 * n, tap, n, byte);
+        C_COPY(s + 3 * n, tcp, n, char);
+    }
+    else
+#endif /* USE_X11_THREAD */
+        x11_pict(td, x, y, n, ap, cp, tap, tcp);
 
     /* Redraw the selection if any, as it may have been obscured. (later) */
     x11_selection->drawn = FALSE;
@@ -2333,6 +2799,154 @@ static errr Term_pict_x11(int x, int y, int n, const byte* ap, const char* cp,
 
 #endif /* USE_GRAPHICS */
 
+#ifdef USE_X11_THREAD
+
+/*
+ * Draw a frame recorded by the hooks (see "x11_record()")
+ *
+ * The lock is only held for one command at a time, so that the game
+ * thread never waits long to handle an event.
+ */
+static void x11_replay(x11_frame* f)
+{
+    u32b i;
+
+    for (i = 0; i < f->cmd_num; i++)
+    {
+        x11_cmd* cmd = &f->cmd[i];
+        char* s = f->data + cmd->data;
+
+        int x1, y1, x2, y2;
+
+        infowin* iwin;
+        infofnt* ifnt;
+        infoclr* iclr;
+
+        (void)pthread_mutex_lock(&x11_mutex);
+
+        /* Save the game's drawing state */
+        iwin = Infowin;
+        ifnt = Infofnt;
+        iclr = Infoclr;
+
+        /* Draw in the window of the command */
+        Infowin_set(cmd->td->win);
+        Infofnt_set(cmd->td->fnt);
+
+        switch (cmd->op)
+        {
+        case X11_CMD_TEXT:
+            Infoclr_set(clr[cmd->a]);
+            Infofnt_text_std(cmd->x, cmd->y, s, cmd->n);
+            break;
+
+        case X11_CMD_WIPE:
+            Infoclr_set(clr[TERM_DARK]);
+            Infofnt_text_non(cmd->x, cmd->y, "", cmd->n);
+            break;
+
+#ifdef USE_GRAPHICS
+        case X11_CMD_PICT:
+            x11_pict(cmd->td, cmd->x, cmd->y, cmd->n, (byte*)s, s + cmd->n,
+                (byte*)(s + 2 * cmd->n), s + 3 * cmd->n);
+            break;
+#endif /* USE_GRAPHICS */
+
+        case X11_CMD_CURS:
+        case X11_CMD_BIGCURS:
+            // Sil-y: changed to blue from xor
+            XDrawRectangle(Metadpy->dpy, Infowin->win, clr[TERM_BLUE]->gc,
+                cmd->x * Infofnt->wid + Infowin->ox,
+                cmd->y * Infofnt->hgt + Infowin->oy,
+                ((cmd->op == X11_CMD_CURS) ? Infofnt->wid : Infofnt->twid) - 1,
+                Infofnt->hgt - 1);
+            break;
+
+        case X11_CMD_CLEAR:
+            Infowin_wipe();
+            break;
+
+        case X11_CMD_MARK:
+            square_to_pixel(&x1, &y1, cmd->x, cmd->y);
+            square_to_pixel(&x2, &y2, cmd->w, cmd->h);
+            XDrawRectangle(Metadpy->dpy, Infowin->win, clr[2]->gc, x1, y1,
+                x2 - x1 + Infofnt->wid - 1, y2 - y1 + Infofnt->hgt - 1);
+            break;
+        }
+
+        /* Restore the game's drawing state */
+        Infowin_set(iwin);
+        Infofnt_set(ifnt);
+        Infoclr_set(iclr);
+
+        (void)pthread_mutex_unlock(&x11_mutex);
+    }
+}
+
+/*
+ * The render thread
+ */
+static void* x11_render(void* arg)
+{
+    /* Unused parameter */
+    (void)arg;
+
+    while (TRUE)
+    {
+        /* Wait for a frame */
+        (void)sem_wait(&x11_wake);
+        if (!atomic_load_explicit(&x11_front_full, memory_order_acquire))
+            continue;
+
+        /* Draw the frame (Xlib does its own locking for the flush) */
+        x11_replay(x11_front);
+        Metadpy_update(1, 0, 0);
+
+        /* Done with the frame */
+        atomic_store_explicit(&x11_front_full, 0, memory_order_release);
+    }
+
+    return (NULL);
+}
+
+/*
+ * Start the render thread, or keep drawing in the game thread if we
+ * cannot
+ */
+static void x11_thread_start(void)
+{
+    pthread_mutexattr_t attr;
+    pthread_t thread;
+
+    /* Event handling may activate another term, and so lock again */
+    (void)pthread_mutexattr_init(&attr);
+    (void)pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    (void)pthread_mutex_init(&x11_mutex, &attr);
+    (void)pthread_mutexattr_destroy(&attr);
+
+    if (sem_init(&x11_wake, 0, 0))
+    {
+        plog("Cannot start the render thread, drawing directly.");
+        return;
+    }
+
+    atomic_init(&x11_front_full, 0);
+
+    /* Draw off-thread from now on (before the thread may take the lock) */
+    x11_threaded = TRUE;
+
+    if (pthread_create(&thread, NULL, x11_render, NULL))
+    {
+        x11_threaded = FALSE;
+        plog("Cannot start the render thread, drawing directly.");
+        return;
+    }
+
+    (void)pthread_detach(thread);
+}
+
+#endif /* USE_X11_THREAD */
+
 /*
  * Initialize a term_data
  */
@@ -2570,6 +3184,12 @@ errr init_x11(int argc, char** argv)
 
 #endif /* USE_GRAPHICS */
 
+#ifdef USE_X11_THREAD
+    /* Xlib will be used from the render thread too */
+    if (!XInitThreads())
+        plog("XInitThreads() failed.");
+#endif /* USE_X11_THREAD */
+
     /* Parse args */
     for (i = 1; i < argc; i++)
     {
@@ -2820,11 +3440,19 @@ errr init_x11(int argc, char** argv)
 
             td->TmpImage = XCreateImage(dpy, visual, depth, ZPixmap, 0, TmpData,
                 td->fnt->twid, td->fnt->hgt, 32, 0);
+
+            /* Prepare the tile cache */
+            C_MAKE(td->tile_cache, X11_TILE_SETS * X11_TILE_WAYS, x11_tile);
         }
     }
 
 #endif /* USE_GRAPHICS */
 
+#ifdef USE_X11_THREAD
+    /* Draw in a separate thread from now on */
+    x11_thread_start();
+#endif /* USE_X11_THREAD */
+
     /* Success */
     return (0);
 }
@@ -368,6 +368,9 @@ int main(int argc, char* argv[])
 
     cptr mstr = NULL;
 
+    cptr record = NULL;
+    cptr replay = NULL;
+
     bool args = TRUE;
 
     /* Save the "program name" XXX XXX XXX */
@@ -559,6 +562,24 @@ int main(int argc, char* argv[])
             continue;
         }
 
+        case 'c':
+        case 'C':
+        {
+            if (!*arg)
+                goto usage;
+            record = arg;
+            continue;
+        }
+
+        case 'p':
+        case 'P':
+        {
+            if (!*arg)
+                goto usage;
+            replay = arg;
+            continue;
+        }
+
         case '-':
         {
             argv[i] = argv[0];
@@ -583,6 +604,8 @@ int main(int argc, char* argv[])
             puts("  -s<num>  Show <num> high scores (default: 10)");
             puts("  -u<who>  Use your <who> savefile");
             puts("  -d<def>  Define a 'lib' dir sub-path");
+            puts("  -c<file> Record the main screen into <file>");
+            puts("  -p<file> Play back the recording <file>");
             puts("  -m<sys>  use Module <sys>, where <sys> can be:");
 
             /* Print the name and help for each available module */
@@ -635,6 +658,27 @@ int main(int argc, char* argv[])
     /* Catch nasty signals */
     signals_init();
 
+    /* Hack -- If requested, play back a recording and quit */
+    if (replay)
+    {
+        FILE* fp = my_fopen(replay, "rb");
+
+        if (!fp || (Term_replay(fp) < 0))
+            quit_fmt("Cannot play back '%s'", replay);
+
+        my_fclose(fp);
+        quit(NULL);
+    }
+
+    /* Hack -- If requested, start recording */
+    if (record)
+    {
+        FILE* fp = my_fopen(record, "wb");
+
+        if (!fp || Term_record_start(fp))
+            quit_fmt("Cannot record into '%s'", record);
+    }
+
     /* Initialize */
     init_angband();
 
@@ -5938,11 +5938,95 @@ static void recover_monster(monster_type* m_ptr)
     calc_stance(m_ptr);
 }
 
+/*
+ * The monster scheduler.
+ *
+ * A monster can only act once it has 100 energy, which at normal speed is
+ * once every ten game turns.  Rather than scanning the whole monster list
+ * on every game turn, "process_monsters()" only visits the monsters marked
+ * in "mon_ready".  A monster is marked whenever its energy might have
+ * reached 100, and unmarked when it is visited and found not to have.
+ */
+static u32b mon_ready[(MAX_MONSTERS + 31) / 32];
+
+/*
+ * Note that a monster's energy might have reached 100
+ */
+void mon_ready_note(int m_idx)
+{
+    mon_ready[m_idx / 32] |= (1UL << (m_idx % 32));
+}
+
+/*
+ * Note that every monster might be ready to act (for a new level)
+ */
+void mon_ready_reset(void)
+{
+    int i;
+
+    C_WIPE(mon_ready, N_ELEMENTS(mon_ready), u32b);
+
+    for (i = 1; i < mon_max; i++)
+        mon_ready_note(i);
+}
+
+/*
+ * Find the highest numbered monster below "m_idx" that might be ready to
+ * act, or 0 if there is none.
+ */
+static int mon_ready_below(int m_idx)
+{
+    int i;
+
+    for (i = m_idx - 1; i >= 1; i--)
+    {
+        u32b word = mon_ready[i / 32];
+
+        /* Skip the rest of an empty word */
+        if (!(word & ((2UL << (i % 32)) - 1)))
+        {
+            i -= i % 32;
+            continue;
+        }
+
+        if (word & (1UL << (i % 32)))
+            return (i);
+    }
+
+    return (0);
+}
+
+/*
+ * Give energy to all monsters, once per game turn
+ */
+void process_monsters_energy(void)
+{
+    int i;
+
+    for (i = mon_max - 1; i >= 1; i--)
+    {
+        /* Access the monster */
+        monster_type* m_ptr = &mon_list[i];
+
+        /* Ignore "dead" monsters */
+        if (!m_ptr->r_idx)
+            continue;
+
+        /* Give this monster some energy */
+        m_ptr->energy += extract_energy[m_ptr->mspeed];
+
+        /* It may be able to act now */
+        if (m_ptr->energy >= 100)
+            mon_ready_note(i);
+    }
+}
+
 /*
  * Process all living monsters, once per game turn.
  *
  * Scan through the list of all living monsters, (backwards, so we can
- * excise any "freshly dead" monsters).
+ * excise any "freshly dead" monsters).  Only the monsters which might have
+ * enough energy are looked at (see "mon_ready"), in the same order.
  *
  * Regenerate monsters when it is their turn to move.
  * Allow fully energized monsters to take their turns.*
@@ -5960,7 +6044,7 @@ void process_monsters(s16b minimum_energy)
         return;
 
     /* Process the monsters (backwards) */
-    for (i = mon_max - 1; i >= 1; i--)
+    for (i = mon_ready_below(mon_max); i >= 1; i = mon_ready_below(i))
     {
         /* Player is dead or leaving the current level */
         if (p_ptr->leaving)
@@ -5969,18 +6053,18 @@ void process_monsters(s16b minimum_energy)
         /* Access the monster */
         m_ptr = &mon_list[i];
 
-        /* Ignore dead monsters */
-        if (!m_ptr->r_idx)
+        /* Ignore dead monsters, and those without enough energy to move */
+        if (!m_ptr->r_idx || (m_ptr->energy < 100))
+        {
+            /* Not ready after all */
+            mon_ready[i / 32] &= ~(1UL << (i % 32));
             continue;
+        }
 
         /* Leave monsters without enough energy for later */
         if (m_ptr->energy < minimum_energy)
             continue;
 
-        /* End the turn of monsters without enough energy to move*/
-        if (m_ptr->energy < 100)
-            continue;
-
         /* Handle temporary monster attributes */
         recover_monster(m_ptr);
 
@@ -6003,7 +6087,9 @@ void process_monsters(s16b minimum_energy)
         }
 
         /* Let the monster take its turn */
+        PROF_ENTER(PROF_PROCESS_MONSTER);
         process_monster(m_ptr);
+        PROF_LEAVE(PROF_PROCESS_MONSTER);
     }
 }
 
@@ -138,6 +138,10 @@ void delete_monster_idx(int i)
     /* Hack -- Reduce the racial counter */
     r_ptr->cur_num--;
 
+    /* The race may be allocated again */
+    if (r_ptr->cur_num + 1 == r_ptr->max_num)
+        alloc_race_stamp++;
+
     /* Hack -- count the number of "reproducers" */
     if (r_ptr->flags2 & (RF2_MULTIPLY))
         num_repro--;
@@ -171,6 +175,9 @@ void delete_monster_idx(int i)
         delete_object_idx(this_o_idx);
     }
 
+    /* Give back its flow */
+    flow_release(i);
+
     /* Wipe the Monster */
     (void)WIPE(m_ptr, monster_type);
 
@@ -243,9 +250,15 @@ static void compact_monsters_aux(int i1, int i2)
     if (p_ptr->health_who == i1)
         p_ptr->health_who = i2;
 
+    /* Hack -- move its flow */
+    flow_move(i1, i2);
+
     /* Hack -- move monster */
     COPY(&mon_list[i2], &mon_list[i1], monster_type);
 
+    /* It may be ready to act in its new place */
+    mon_ready_note(i2);
+
     /* Hack -- wipe hole */
     (void)WIPE(&mon_list[i1], monster_type);
 }
@@ -415,6 +428,10 @@ void wipe_mon_list(void)
         /* Hack -- Reduce the racial counter */
         r_ptr->cur_num--;
 
+        /* The race may be allocated again */
+        if (r_ptr->cur_num + 1 == r_ptr->max_num)
+            alloc_race_stamp++;
+
         /* Monster is gone */
         cave_m_idx[m_ptr->fy][m_ptr->fx] = 0;
 
@@ -521,6 +538,9 @@ errr get_mon_num_prep(void)
         }
     }
 
+    /* The cached bands are stale */
+    alloc_race_stamp++;
+
     /* Success */
     return (0);
 }
@@ -529,9 +549,10 @@ errr get_mon_num_prep(void)
  * Choose a monster race that seems "appropriate" to the given level
  *
  * This function uses the "prob2" field of the "monster allocation table",
- * and various local information, to calculate the "prob3" field of the
- * same table, which is then used to choose an "appropriate" monster, in
- * a relatively efficient manner.
+ * and various local information, to calculate the running totals of a
+ * cached band of the same table, which is then used to choose an
+ * "appropriate" monster by binary search.  The band is only rebuilt when
+ * the conditions or the allocator stamp change.
  *
  * There is a small chance (1/50) of "boosting" the given depth by
  * a small amount (up to four levels), and
@@ -572,6 +593,10 @@ s16b get_mon_num(int level, bool special, bool allow_non_smart, bool vault)
 
     alloc_entry* table = alloc_race_table;
 
+    alloc_band* band;
+
+    u32b key;
+
     int generation_level;
 
     bool pursuing_monster = FALSE;
@@ -652,18 +677,26 @@ s16b get_mon_num(int level, bool special, bool allow_non_smart, bool vault)
             generation_level = MORGOTH_DEPTH + 3;
     }
 
+    /* Everything the probabilities below depend on */
+    key = generation_level | (special ? 0x100 : 0)
+        | (pursuing_monster ? 0x200 : 0) | (allow_non_smart ? 0x400 : 0)
+        | ((u32b)p_ptr->depth << 16);
+
+    /* Reuse the band if these conditions have been seen before */
+    band = alloc_band_find(alloc_race_band, key, alloc_race_stamp);
+
     /* Reset total */
     total = 0L;
 
     /* Process probabilities */
-    for (i = 0; i < alloc_race_size; i++)
+    for (i = 0; (band->num < 0) && (i < alloc_race_size); i++)
     {
         /* Monsters are sorted by depth */
         if (table[i].level > generation_level)
             break;
 
         /* Default */
-        table[i].prob3 = 0;
+        band->total[i] = total;
 
         /* Get the "r_idx" of the chosen monster */
         r_idx = table[i].index;
@@ -713,12 +746,19 @@ s16b get_mon_num(int level, bool special, bool allow_non_smart, bool vault)
             continue;
 
         /* Accept */
-        table[i].prob3 = table[i].prob2;
+        total += table[i].prob2;
 
         /* Total */
-        total += table[i].prob3;
+        band->total[i] = total;
     }
 
+    /* Remember the band */
+    if (band->num < 0)
+        band->num = i;
+
+    /* Total of the band */
+    total = (band->num > 0) ? band->total[band->num - 1] : 0L;
+
     /* No legal monsters */
     if (total <= 0)
         return (0);
@@ -727,15 +767,7 @@ s16b get_mon_num(int level, bool special, bool allow_non_smart, bool vault)
     value = rand_int(total);
 
     /* Find the monster */
-    for (i = 0; i < alloc_race_size; i++)
-    {
-        /* Found the entry */
-        if (value < table[i].prob3)
-            break;
-
-        /* Decrement */
-        value = value - table[i].prob3;
-    }
+    i = alloc_band_pick(band, value);
 
     /* Result */
     return (table[i].index);
@@ -1720,6 +1752,8 @@ void update_monsters(bool full)
 {
     int i;
 
+    PROF_ENTER(PROF_UPDATE_MONSTERS);
+
     /* Update each (live) monster */
     for (i = 1; i < mon_max; i++)
     {
@@ -1732,6 +1766,8 @@ void update_monsters(bool full)
         /* Update the monster */
         update_mon(i, full);
     }
+
+    PROF_LEAVE(PROF_UPDATE_MONSTERS);
 }
 
 /*
@@ -2201,7 +2237,10 @@ s16b player_place(int y, int x)
     /* Mark cave grid */
     cave_m_idx[y][x] = -1;
     if (cave_feat[y][x] == FEAT_RUBBLE)
+    {
         cave_feat[y][x] = FEAT_FLOOR;
+        flow_note_change(y, x);
+    }
 
     /* Success */
     return (-1);
@@ -2236,6 +2275,9 @@ s16b monster_place(int y, int x, monster_type* n_ptr)
         /* Copy the monster XXX */
         COPY(m_ptr, n_ptr, monster_type);
 
+        /* It may be ready to act (if it was loaded from a savefile) */
+        mon_ready_note(m_idx);
+
         /* Location */
         m_ptr->fy = y;
         m_ptr->fx = x;
@@ -2256,6 +2298,10 @@ s16b monster_place(int y, int x, monster_type* n_ptr)
 
         /* Count racial occurances */
         r_ptr->cur_num++;
+
+        /* The race may no longer be allocated */
+        if (r_ptr->cur_num == r_ptr->max_num)
+            alloc_race_stamp++;
     }
 
     /* Result */
@@ -228,6 +228,9 @@ void reset_visuals(bool unused)
         f_ptr->x_char = f_ptr->d_char;
     }
 
+    /* The cached map glyphs are stale */
+    map_info_forget();
+
     /* Extract default attr/char code for objects */
     for (i = 0; i < z_info->k_max; i++)
     {
@@ -553,7 +556,7 @@ void strip_name(char* buf, int k_idx)
  *   2 -- Amulet of Death [1,+3] <+2>
  *   3 -- Rings of Death [1,+3] <+2> {nifty}
  */
-void object_desc(
+static void object_desc_aux(
     char* buf, size_t max, const object_type* o_ptr, int pref, int mode)
 {
     cptr basenm;
@@ -1315,6 +1318,120 @@ object_desc_done:
     my_strcpy(buf, tmp_buf, max);
 }
 
+/*
+ * Size of the cache of object descriptions (a power of two)
+ */
+#define OBJECT_DESC_CACHE 128
+
+/*
+ * A cached object description
+ *
+ * The description depends only on the object itself, on a few things the
+ * player knows, on the name of its artefact (which smithing and randarts
+ * rewrite in place), and on the arguments, so all of these are kept to
+ * check that the description is still the right one.  Objects are changed in
+ * place (by identification, inscription, stacking, charges and so on) in
+ * a great many places, so a copy of the whole object is kept instead of
+ * a version stamp which every one of these would have to remember to bump.
+ */
+typedef struct object_desc_entry object_desc_entry;
+
+struct object_desc_entry
+{
+    object_type obj; /* The object as it was described */
+    s16b flavor; /* Its flavor */
+    byte know; /* What was known (see "object_desc_know()") */
+    byte bonus; /* Its "hand and a half" bonus */
+    s16b pref; /* The arguments */
+    s16b mode;
+    char art_name[MAX_LEN_ART_NAME]; /* Its artefact name */
+    bool used; /* The entry is in use */
+    char desc[128]; /* The description */
+};
+
+static object_desc_entry object_desc_cache[OBJECT_DESC_CACHE];
+
+/*
+ * Extract the things the player knows that the description of "o_ptr"
+ * depends on
+ */
+static byte object_desc_know(const object_type* o_ptr)
+{
+    object_kind* k_ptr = &k_info[o_ptr->k_idx];
+
+    byte know = 0;
+
+    if (k_ptr->aware)
+        know |= 0x01;
+    if (k_ptr->tried)
+        know |= 0x02;
+
+    /* Staffs show more charges with channeling */
+    if ((o_ptr->tval == TV_STAFF)
+        && p_ptr->active_ability[S_WIL][WIL_CHANNELING])
+        know |= 0x04;
+
+    /* Herbs are different at Easter */
+    if ((o_ptr->tval == TV_FOOD) && (o_ptr->sval < SV_FOOD_MIN_FOOD)
+        && easter_time())
+        know |= 0x08;
+
+    return (know);
+}
+
+/*
+ * Describe the object "o_ptr" (see "object_desc_aux()" above), using a
+ * cached description if the object and what is known about it have not
+ * changed since it was last described.
+ *
+ * The inventory and equipment (and their sub-windows) are redrawn very
+ * often, and nearly always describe the very same objects.
+ */
+void object_desc(
+    char* buf, size_t max, const object_type* o_ptr, int pref, int mode)
+{
+    object_desc_entry* e;
+
+    byte know = object_desc_know(o_ptr);
+    byte bonus = (byte)hand_and_a_half_bonus(o_ptr);
+    s16b flavor = k_info[o_ptr->k_idx].flavor;
+
+    /* Artefact names can change in place (smithing, randarts, loading) */
+    cptr art_name = o_ptr->name1 ? a_info[o_ptr->name1].name : "";
+
+    /* Hash the object (by address) and the arguments */
+    size_t i = ((size_t)o_ptr / sizeof(object_type)) + (mode + 1) * 37
+        + (pref ? 17 : 0);
+
+    e = &object_desc_cache[i & (OBJECT_DESC_CACHE - 1)];
+
+    /* Note that the player has seen the object (as "object_desc_aux()") */
+    if ((know & 0x01) || (o_ptr->ident & (IDENT_SPOIL)))
+        k_info[o_ptr->k_idx].everseen = TRUE;
+
+    /* Describe it again, unless it is unchanged */
+    if (!e->used || (e->know != know) || (e->bonus != bonus)
+        || (e->flavor != flavor) || (e->pref != pref) || (e->mode != mode)
+        || !streq(e->art_name, art_name)
+        || memcmp(&e->obj, o_ptr, sizeof(object_type)))
+    {
+        object_desc_aux(e->desc, sizeof(e->desc), o_ptr, pref, mode);
+
+        /* Remember */
+        COPY(&e->obj, o_ptr, object_type);
+        e->know = know;
+        e->bonus = bonus;
+        e->flavor = flavor;
+        e->pref = pref;
+        e->mode = mode;
+        my_strcpy(e->art_name, art_name, sizeof(e->art_name));
+        e->used = TRUE;
+    }
+
+    /* Copy the description */
+    my_strcpy(buf, e->desc, max);
+}
+
 /*
  * Describe an item and pretend the item is fully known and has no flavor.
  */
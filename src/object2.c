@@ -612,15 +612,19 @@ void get_obj_num_prep(void)
             table[i].prob2 = 0;
         }
     }
+
+    /* The cached bands are stale */
+    alloc_kind_stamp++;
 }
 
 /*
  * Choose an object kind that seems "appropriate" to the given level
  *
  * This function uses the "prob2" field of the "object allocation table",
- * and various local information, to calculate the "prob3" field of the
- * same table, which is then used to choose an "appropriate" object, in
- * a relatively efficient manner.
+ * and various local information, to calculate the running totals of a
+ * cached band of the same table, which is then used to choose an
+ * "appropriate" object by binary search.  The band is only rebuilt when
+ * the level, the generation mode or the allocator stamp change.
  *
  * It is (slightly) more likely to acquire an object of the given level
  * than one of a lower level.  This is done by choosing several objects
@@ -642,6 +646,8 @@ s16b get_obj_num(int level)
 
     alloc_entry* table = alloc_kind_table;
 
+    alloc_band* band;
+
     /* Boost level */
     if (level > 0)
     {
@@ -666,18 +672,23 @@ s16b get_obj_num(int level)
         }
     }
 
+    /* Reuse the band if this level has been seen before */
+    band = alloc_band_find(alloc_kind_band,
+        ((u32b)level << 1) | (object_generation_mode == OB_GEN_MODE_CHEST),
+        alloc_kind_stamp);
+
     /* Reset total */
     total = 0L;
 
     /* Process probabilities */
-    for (i = 0; i < alloc_kind_size; i++)
+    for (i = 0; (band->num < 0) && (i < alloc_kind_size); i++)
     {
         /* Objects are sorted by depth */
         if (table[i].level > level)
             break;
 
         /* Default */
-        table[i].prob3 = 0;
+        band->total[i] = total;
 
         /* Get the index */
         k_idx = table[i].index;
@@ -691,12 +702,19 @@ s16b get_obj_num(int level)
             continue;
 
         /* Accept */
-        table[i].prob3 = table[i].prob2;
+        total += table[i].prob2;
 
         /* Total */
-        total += table[i].prob3;
+        band->total[i] = total;
     }
 
+    /* Remember the band */
+    if (band->num < 0)
+        band->num = i;
+
+    /* Total of the band */
+    total = (band->num > 0) ? band->total[band->num - 1] : 0L;
+
     /* No legal objects */
     if (total <= 0)
         return (0);
@@ -705,15 +723,7 @@ s16b get_obj_num(int level)
     value = rand_int(total);
 
     /* Find the object */
-    for (i = 0; i < alloc_kind_size; i++)
-    {
-        /* Found the entry */
-        if (value < table[i].prob3)
-            break;
-
-        /* Decrement */
-        value = value - table[i].prob3;
-    }
+    i = alloc_band_pick(band, value);
 
     /* Power boost */
     p = rand_int(100);
@@ -728,15 +738,7 @@ s16b get_obj_num(int level)
         value = rand_int(total);
 
         /* Find the monster */
-        for (i = 0; i < alloc_kind_size; i++)
-        {
-            /* Found the entry */
-            if (value < table[i].prob3)
-                break;
-
-            /* Decrement */
-            value = value - table[i].prob3;
-        }
+        i = alloc_band_pick(band, value);
 
         /* Keep the "best" one */
         if (table[i].level < table[j].level)
@@ -753,15 +755,7 @@ s16b get_obj_num(int level)
         value = rand_int(total);
 
         /* Find the object */
-        for (i = 0; i < alloc_kind_size; i++)
-        {
-            /* Found the entry */
-            if (value < table[i].prob3)
-                break;
-
-            /* Decrement */
-            value = value - table[i].prob3;
-        }
+        i = alloc_band_pick(band, value);
 
         /* Keep the "best" one */
         if (table[i].level < table[j].level)
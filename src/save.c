@@ -365,26 +365,120 @@ static errr rd_savefile(void)
  * Some "local" parameters, used to help write savefiles
  */
 
-static FILE* fff; /* Current save "file" */
+static int sf_fd = -1; /* Current save "file" */
 
 static byte xor_byte; /* Simple encryption */
 
 static u32b v_stamp = 0L; /* A simple "checksum" on the actual values */
 static u32b x_stamp = 0L; /* A simple "checksum" on the encoded bytes */
 
+/*
+ * The savefile is written a block at a time.  Values are collected in
+ * the block, encoded (and added to the checksums) a whole run at a time,
+ * and each full block is written with a single "write()".  The result is
+ * exactly the same as encoding and writing one byte at a time.
+ */
+#define SF_BLOCK 16384
+
+static byte sf_block[SF_BLOCK]; /* The block being written */
+static size_t sf_len; /* Bytes in the block */
+static size_t sf_done; /* Bytes of the block already encoded */
+static bool sf_error; /* A write failed */
+static u32b sf_total; /* Bytes written before the block */
+
+/*
+ * The section table, written at the end of the savefile
+ */
+static sf_section sf_toc[SF_SECT_MAX];
+static int sf_sections;
+
+/*
+ * Encode the values in the block which have not been encoded yet
+ */
+static void sf_encode(void)
+{
+    byte* s = sf_block + sf_done;
+    byte* end = sf_block + sf_len;
+
+    byte x = xor_byte;
+    u32b v_sum = 0L, x_sum = 0L;
+
+    /* Encode the values, maintain the checksum info */
+    for (; s < end; s++)
+    {
+        v_sum += *s;
+        x ^= *s;
+        *s = x;
+        x_sum += x;
+    }
+
+    xor_byte = x;
+    v_stamp += v_sum;
+    x_stamp += x_sum;
+
+    sf_done = sf_len;
+}
+
+/*
+ * Encode the block, and write it out
+ */
+static void sf_flush(void)
+{
+    sf_encode();
+
+    /* Write the block */
+    if (sf_len && fd_write(sf_fd, (cptr)sf_block, sf_len))
+        sf_error = TRUE;
+
+    sf_total += (u32b)sf_len;
+    sf_len = sf_done = 0;
+}
+
+/*
+ * Start a new section of the savefile
+ */
+static void wr_section_begin(u16b type)
+{
+    sf_section* s = &sf_toc[sf_sections];
+
+    /* Bring the checksums up to date */
+    sf_encode();
+
+    /* Remember where the section starts */
+    s->type = type;
+    s->offset = sf_total + (u32b)sf_len;
+    s->v_sum = v_stamp;
+    s->x_sum = x_stamp;
+}
+
+/*
+ * Finish the current section of the savefile
+ */
+static void wr_section_end(void)
+{
+    sf_section* s = &sf_toc[sf_sections++];
+
+    /* Bring the checksums up to date */
+    sf_encode();
+
+    /* Measure the section */
+    s->length = sf_total + (u32b)sf_len - s->offset;
+    s->v_sum = v_stamp - s->v_sum;
+    s->x_sum = x_stamp - s->x_sum;
+}
+
 /*
  * These functions place information into a savefile a byte at a time
  */
 
 static void sf_put(byte v)
 {
-    /* Encode the value, write a character */
-    xor_byte ^= v;
-    (void)putc((int)xor_byte, fff);
+    /* Make room */
+    if (sf_len == SF_BLOCK)
+        sf_flush();
 
-    /* Maintain the checksum info */
-    v_stamp += v;
-    x_stamp += xor_byte;
+    /* Save the value (to be encoded later) */
+    sf_block[sf_len++] = v;
 }
 
 static void wr_byte(byte v) { sf_put(v); }
@@ -670,8 +764,12 @@ static void wr_options(void)
     /* Write "hitpoint_warn" */
     wr_byte(op_ptr->hitpoint_warn);
 
-    // 8 spare bytes
-    wr_u32b(0L);
+    /* Write "frame_budget" */
+    wr_byte(op_ptr->frame_budget);
+
+    // 7 spare bytes
+    wr_byte(0);
+    wr_u16b(0);
     wr_u32b(0L);
 
     /*** Normal options ***/
@@ -1021,6 +1119,9 @@ static void wr_notes(void)
     int i = 0;
     int j = 0;
 
+    /* The notes may not have been read from the old savefile yet */
+    load_notes();
+
     // Sil: I've had to re-do this with the removal of the notes file
     //      The code below is pretty verbose and surely there was a better way!
     while (!done)
@@ -1207,6 +1308,34 @@ static void wr_dungeon(void)
     }
 }
 
+/*
+ * Write the section table, followed by its own offset
+ */
+static void wr_toc(void)
+{
+    int i;
+
+    u32b offset;
+
+    /* Find the table */
+    sf_encode();
+    offset = sf_total + (u32b)sf_len;
+
+    /* Dump the sections */
+    wr_u16b((u16b)sf_sections);
+    for (i = 0; i < sf_sections; i++)
+    {
+        wr_u16b(sf_toc[i].type);
+        wr_u32b(sf_toc[i].offset);
+        wr_u32b(sf_toc[i].length);
+        wr_u32b(sf_toc[i].v_sum);
+        wr_u32b(sf_toc[i].x_sum);
+    }
+
+    /* Dump the location of the table */
+    wr_u32b(offset);
+}
+
 /*
  * Actually write a save-file
  */
@@ -1232,15 +1361,15 @@ static bool wr_savefile(void)
 
     /*** Actually write the file ***/
 
-    /* Dump the file header */
-    xor_byte = 0;
-    wr_byte(VERSION_MAJOR);
-    xor_byte = 0;
-    wr_byte(VERSION_MINOR);
-    xor_byte = 0;
-    wr_byte(VERSION_PATCH);
-    xor_byte = 0;
-    wr_byte(VERSION_EXTRA);
+    /* Dump the file header (each byte is encoded on its own) */
+    sf_block[0] = VERSION_MAJOR;
+    sf_block[1] = VERSION_MINOR;
+    sf_block[2] = VERSION_PATCH;
+    sf_block[3] = VERSION_EXTRA;
+    sf_len = sf_done = 4;
+    sf_total = 0L;
+    sf_sections = 0;
+    xor_byte = VERSION_EXTRA;
 
     /* Reset the checksum */
     v_stamp = 0L;
@@ -1258,17 +1387,20 @@ static bool wr_savefile(void)
     /* Number of times saved */
     wr_u16b(sf_saves);
 
-    // 8 spare bytes
-    wr_u32b(0L);
-    wr_u32b(0L);
+    // 8 spare bytes (which now mark a sectioned savefile)
+    wr_u32b(SF_SECTIONS);
+    wr_u32b(SF_SECTION_VERSION);
 
     /* Write the RNG state */
+    wr_section_begin(SF_SECT_OPTIONS);
     wr_randomizer();
 
     /* Write the boolean "options" */
     wr_options();
+    wr_section_end();
 
     /* Dump the number of "messages" */
+    wr_section_begin(SF_SECT_MESSAGES);
     tmp16u = message_num();
     wr_u16b(tmp16u);
 
@@ -1278,14 +1410,18 @@ static bool wr_savefile(void)
         wr_string(message_str((s16b)i));
         wr_u16b(message_type((s16b)i));
     }
+    wr_section_end();
 
     /* Dump the monster lore */
+    wr_section_begin(SF_SECT_LORE);
     tmp16u = z_info->r_max;
     wr_u16b(tmp16u);
     for (i = 0; i < tmp16u; i++)
         wr_lore(i);
+    wr_section_end();
 
     /* Dump the object memory */
+    wr_section_begin(SF_SECT_KNOWLEDGE);
     tmp16u = z_info->k_max;
     wr_u16b(tmp16u);
     for (i = 0; i < tmp16u; i++)
@@ -1300,17 +1436,23 @@ static bool wr_savefile(void)
         wr_byte(a_ptr->cur_num);
         wr_byte(a_ptr->found_num);
     }
+    wr_section_end();
 
     /* Write the "extra" information */
+    wr_section_begin(SF_SECT_PLAYER);
     wr_extra();
 
     /*Write the randarts*/
     wr_randarts();
+    wr_section_end();
 
     /*Copy the notes file into the savefile*/
+    wr_section_begin(SF_SECT_NOTES);
     wr_notes();
+    wr_section_end();
 
     // Write the smithing item
+    wr_section_begin(SF_SECT_INVEN);
     wr_item(smith_o_ptr);
 
     /* Write the inventory */
@@ -1331,22 +1473,33 @@ static bool wr_savefile(void)
 
     /* Add a sentinel */
     wr_u16b(0xFFFF);
+    wr_section_end();
 
     /* Player is not dead, write the dungeon */
     if (!p_ptr->is_dead)
     {
         /* Dump the dungeon */
+        wr_section_begin(SF_SECT_DUNGEON);
         wr_dungeon();
+        wr_section_end();
     }
 
+    /* Write the section table */
+    wr_toc();
+
     /* Write the "value check-sum" */
+    sf_encode();
     wr_u32b(v_stamp);
 
     /* Write the "encoded checksum" */
+    sf_encode();
     wr_u32b(x_stamp);
 
+    /* Write the last block */
+    sf_flush();
+
     /* Error in save */
-    if (ferror(fff) || (fflush(fff) == EOF))
+    if (sf_error)
         return FALSE;
 
     /* Successful save */
@@ -1355,19 +1508,17 @@ static bool wr_savefile(void)
 
 /*
  * Medium level player saver
- *
- * XXX XXX XXX Angband 2.8.0 will use "fd" instead of "fff" if possible
  */
 static bool save_player_aux(cptr name)
 {
     bool ok = FALSE;
 
-    int fd;
-
     int mode = 0644;
 
     /* No file yet */
-    fff = NULL;
+    sf_fd = -1;
+    sf_len = sf_done = 0;
+    sf_error = FALSE;
 
     /* File type is "SAVE" */
     FILE_TYPE(FILE_TYPE_SAVE);
@@ -1376,37 +1527,22 @@ static bool save_player_aux(cptr name)
     safe_setuid_grab();
 
     /* Create the savefile */
-    fd = fd_make(name, mode);
+    sf_fd = fd_make(name, mode);
 
     /* Drop permissions */
     safe_setuid_drop();
 
     /* File is okay */
-    if (fd >= 0)
+    if (sf_fd >= 0)
     {
-        /* Close the "fd" */
-        fd_close(fd);
-
-        /* Grab permissions */
-        safe_setuid_grab();
-
-        /* Open the savefile */
-        fff = my_fopen(name, "wb");
-
-        /* Drop permissions */
-        safe_setuid_drop();
-
-        /* Successful open */
-        if (fff)
-        {
-            /* Write the savefile */
-            if (wr_savefile())
-                ok = TRUE;
-
-            /* Attempt to close it */
-            if (my_fclose(fff))
-                ok = FALSE;
-        }
+        /* Write the savefile */
+        if (wr_savefile())
+            ok = TRUE;
+
+        /* Attempt to close it */
+        if (fd_close(sf_fd))
+            ok = FALSE;
+        sf_fd = -1;
 
         /* Grab permissions */
         safe_setuid_grab();
@@ -623,6 +623,7 @@ void take_hit(int dam, cptr kb_str)
         (void)strftime(long_day, 40, "%d %B %Y", localtime(&ct));
 
         /* Add note */
+        load_notes();
         my_strcat(notes_buffer, "\n", sizeof(notes_buffer));
 
         /*killed by */
@@ -3809,6 +3810,8 @@ bool project(int who, int rad, int y0, int x0, int y1, int x1, int dd, int ds,
 
     int degree, max_dist;
 
+    PROF_ENTER(PROF_PROJECT);
+
     /* Hack -- Flush any pending output */
     handle_stuff();
 
@@ -3911,15 +3914,15 @@ bool project(int who, int rad, int y0, int x0, int y1, int x1, int dd, int ds,
                     print_rel(c, a, y, x);
                     move_cursor_relative(y, x);
                     if (op_ptr->delay_factor)
-                        Term_fresh();
+                        frame_fresh();
 
                     /* Delay */
-                    Term_xtra(TERM_XTRA_DELAY, msec);
+                    frame_delay(msec);
 
                     /* Erase the visual effects */
                     lite_spot(y, x);
                     if (op_ptr->delay_factor)
-                        Term_fresh();
+                        frame_fresh();
 
                     /* Re-display the beam  XXX */
                     if (flg & (PROJECT_BEAM))
@@ -3943,7 +3946,7 @@ bool project(int who, int rad, int y0, int x0, int y1, int x1, int dd, int ds,
                 else if (visual)
                 {
                     /* Delay for consistency */
-                    Term_xtra(TERM_XTRA_DELAY, msec);
+                    frame_delay(msec);
                 }
             }
         }
@@ -4262,12 +4265,12 @@ bool project(int who, int rad, int y0, int x0, int y1, int x1, int dd, int ds,
             {
                 /* Flush each radius separately */
                 if (op_ptr->delay_factor)
-                    Term_fresh();
+                    frame_fresh();
 
                 /* Delay (efficiently) */
                 if (visual || drawn)
                 {
-                    Term_xtra(TERM_XTRA_DELAY, msec);
+                    frame_delay(msec);
                 }
             }
         }
@@ -4276,8 +4279,8 @@ bool project(int who, int rad, int y0, int x0, int y1, int x1, int dd, int ds,
         if ((grids > 1) && (visual || drawn))
         {
             if (!op_ptr->delay_factor)
-                Term_fresh();
-            Term_xtra(TERM_XTRA_DELAY, 50 + msec);
+                frame_fresh();
+            frame_delay(50 + msec);
         }
 
         /* Flush the erasing -- except if we specify lingering graphics */
@@ -4302,10 +4305,13 @@ bool project(int who, int rad, int y0, int x0, int y1, int x1, int dd, int ds,
 
             /* Flush the explosion */
             if (op_ptr->delay_factor)
-                Term_fresh();
+                frame_fresh();
         }
     }
 
+    /* Show the end of the animation */
+    frame_flush();
+
     /* Check features */
     if (flg & (PROJECT_GRID))
     {
@@ -4433,6 +4439,8 @@ bool project(int who, int rad, int y0, int x0, int y1, int x1, int dd, int ds,
     if (p_ptr->update)
         update_stuff();
 
+    PROF_LEAVE(PROF_PROJECT);
+
     /* Return "something was noticed" */
     return (notice);
 }
@@ -5015,6 +5023,7 @@ void hatch_spider(monster_type* m_ptr)
 
     // Monster still gets to attack next turn
     m_ptr->energy += 50;
+    mon_ready_note(cave_m_idx[m_ptr->fy][m_ptr->fx]);
 }
 
 /*
@@ -72,6 +72,8 @@ typedef struct vault_type vault_type;
 typedef struct object_type object_type;
 typedef struct monster_type monster_type;
 typedef struct alloc_entry alloc_entry;
+typedef struct alloc_band alloc_band;
+typedef struct level_context level_context;
 typedef struct owner_type owner_type;
 typedef struct store_type store_type;
 typedef struct player_race player_race;
@@ -84,6 +86,7 @@ typedef struct names_type names_type;
 typedef struct flavor_type flavor_type;
 typedef struct editing_buffer editing_buffer;
 typedef struct autoinscription autoinscription;
+typedef struct sf_section sf_section;
 
 /**** Available structs ****/
 
@@ -625,6 +628,68 @@ struct alloc_entry
     u16b total; /* Unused for now */
 };
 
+/*
+ * A cached "band" of an allocation table
+ *
+ * Holds the running totals of pass 3 over the table prefix for one set of
+ * allocation conditions, valid while the allocator stamp is unchanged.
+ */
+struct alloc_band
+{
+    u32b key; /* Allocation conditions */
+    u32b stamp; /* Allocator stamp when built */
+    u32b used; /* Last use (for replacement) */
+
+    s16b num; /* Entries in the prefix (or -1 if unbuilt) */
+
+    s32b* total; /* Running totals[num] */
+};
+
+/*
+ * Everything that belongs to one dungeon level
+ *
+ * The usual globals ("cave_info", "mon_list", "o_max", ...) describe the
+ * active level; see "level_context_swap()".
+ */
+struct level_context
+{
+    u16b_256* info; /* Cave grid info flags (as "cave_info") */
+    byte_wid* feat; /* Cave grid features */
+    s16b_wid* light; /* Cave grid light levels */
+    s16b_wid* o_idx; /* Cave grid object indexes */
+    s16b_wid* m_idx; /* Cave grid monster indexes */
+    byte_wid* when; /* Cave grid scent stamps */
+
+    object_type* o_list; /* Objects (as "o_list") */
+    monster_type* mon_list; /* Monsters (as "mon_list") */
+
+    s16b o_max; /* Number of allocated objects */
+    s16b o_cnt; /* Number of live objects */
+    s16b mon_max; /* Number of allocated monsters */
+    s16b mon_cnt; /* Number of live monsters */
+
+    int scent_when; /* Current scent age marker */
+
+    s16b depth; /* Dungeon level */
+    s16b py; /* Player location */
+    s16b px;
+    byte cur_map_hgt; /* Size of the level */
+    byte cur_map_wid;
+
+    byte flow_center_y[MAX_WANDERING_GROUPS]; /* Wandering flow centres */
+    byte flow_center_x[MAX_WANDERING_GROUPS];
+    s16b wandering_pause[MAX_WANDERING_GROUPS]; /* Wandering group pauses */
+
+    s16b num_repro; /* Reproducer count */
+
+    bool do_feeling; /* Level feeling state (as "feeling") */
+    byte feeling;
+    s16b rating;
+    bool good_item_flag;
+
+    char vault_name[80]; /* Name of the level's vault (as "g_vault_name") */
+};
+
 /*
  * A store owner
  */
@@ -747,6 +812,8 @@ struct player_other
     byte hitpoint_warn; /* Hitpoint warning (0 to 9) */
 
     byte delay_factor; /* Delay factor (0 to 9) */
+
+    byte frame_budget; /* Animation frame budget (0 to 9, x10 msec) */
 };
 
 /*
@@ -1185,3 +1252,15 @@ struct autoinscription
     s16b kindIdx;
     s16b inscriptionIdx;
 };
+
+/*
+ * An entry in the savefile section table
+ */
+struct sf_section
+{
+    u16b type; /* Section type (SF_SECT_*) */
+    u32b offset; /* First byte of the section */
+    u32b length; /* Bytes in the section */
+    u32b v_sum; /* Sum of the values */
+    u32b x_sum; /* Sum of the encoded bytes */
+};
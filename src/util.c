@@ -1654,6 +1654,133 @@ void flush(void)
  */
 void flush_fail(void) { flush(); }
 
+/*
+ * Animation frame scheduler
+ *
+ * Animations (bolts, balls, running) draw a frame, refresh the screen and
+ * then delay.  With a frame budget ("op_ptr->frame_budget", in units of
+ * 10 msec) the delays only advance an animation clock, and the screen is
+ * refreshed at most once per budget: a delay shows the current screen
+ * (after sleeping until the animation clock is reached) unless the last
+ * frame was shown less than a budget ago, in which case it is coalesced
+ * with the next one.  Refreshes between delays are only done once per
+ * budget of wall clock time, so that animations with no delays at all
+ * (instant running) still show some progress.  If the game is running
+ * late, the owed delay is dropped.  A budget of zero keeps the old
+ * behaviour of one refresh and one delay per frame.
+ */
+static bool frame_active; /* An animation is in progress */
+static double frame_start; /* Wall clock when it began (msec) */
+static double frame_clock; /* Delay requested so far (msec) */
+static double frame_last; /* When the last frame was shown (msec) */
+
+/*
+ * Start an animation, if none is in progress
+ */
+static void frame_begin(double now)
+{
+    if (frame_active)
+        return;
+
+    frame_active = TRUE;
+    frame_start = now;
+    frame_clock = 0.0;
+
+    /* The first frame is always shown */
+    frame_last = now - op_ptr->frame_budget * 10;
+}
+
+/*
+ * Delay an animation by "msec" (see above)
+ */
+void frame_delay(int msec)
+{
+    double now, due;
+
+    /* No budget */
+    if (!op_ptr->frame_budget)
+    {
+        Term_xtra(TERM_XTRA_DELAY, msec);
+        return;
+    }
+
+    now = clock_msec();
+
+    frame_begin(now);
+
+    /* The current frame is due now, on the animation clock */
+    due = frame_start + frame_clock;
+
+    /* Running late -- drop the owed delay */
+    if (due < now)
+    {
+        frame_start += now - due;
+        due = now;
+    }
+
+    /* Show the frame, unless it is too soon after the last one */
+    if (due - frame_last >= op_ptr->frame_budget * 10)
+    {
+        if (due > now)
+            Term_xtra(TERM_XTRA_DELAY, (int)(due - now));
+
+        Term_fresh();
+
+        frame_last = due;
+    }
+
+    /* Advance the animation clock */
+    frame_clock += msec;
+}
+
+/*
+ * Refresh the screen during an animation (see above)
+ */
+void frame_fresh(void)
+{
+    double now;
+
+    /* No budget */
+    if (!op_ptr->frame_budget)
+    {
+        Term_fresh();
+        return;
+    }
+
+    now = clock_msec();
+
+    frame_begin(now);
+
+    /* Coalesce with the next frame */
+    if (now - frame_last < op_ptr->frame_budget * 10)
+        return;
+
+    Term_fresh();
+
+    frame_last = now;
+}
+
+/*
+ * Show the last frame of an animation, and end it
+ */
+void frame_flush(void)
+{
+    double now;
+
+    /* Nothing in progress */
+    if (!frame_active)
+        return;
+
+    frame_active = FALSE;
+
+    /* Let the animation finish */
+    now = clock_msec();
+    if (frame_start + frame_clock > now)
+        Term_xtra(TERM_XTRA_DELAY, (int)(frame_start + frame_clock - now));
+
+    Term_fresh();
+}
+
 /*
  * Local variable -- we are inside a "macro action"
  *
@@ -2340,6 +2467,9 @@ static s16b message_age2idx(int age)
  */
 s16b message_num(void)
 {
+    /* The savefile may still hold the old messages */
+    load_messages();
+
     /* Determine how many messages are "available" */
     return (message_age2idx(message__last - 1));
 }
@@ -2354,6 +2484,9 @@ cptr message_str(s16b age)
     u16b o;
     cptr s;
 
+    /* The savefile may still hold the old messages */
+    load_messages();
+
     /* Forgotten messages have no text */
     if ((age < 0) || (age >= message_num()))
         return ("");
@@ -2385,6 +2518,9 @@ u16b message_type(s16b age)
 {
     s16b x;
 
+    /* The savefile may still hold the old messages */
+    load_messages();
+
     /* Paranoia */
     if (!message__type)
         return (MSG_GENERIC);
@@ -2452,6 +2588,9 @@ void message_add(cptr str, u16b type)
     cptr u;
     char* v;
 
+    /* Older messages come first */
+    load_messages();
+
     /*** Step 1 -- Analyze the message ***/
 
     /* Hack -- Ignore "non-messages" */
@@ -116,6 +116,10 @@ s16b o_cnt = 0; /* Number of live objects */
 s16b mon_max = 1; /* Number of allocated monsters */
 s16b mon_cnt = 0; /* Number of live monsters */
 
+u16b gen_tries = 0; /* Attempts at the last level generated */
+u16b gen_rooms = 0; /* Rooms (and vaults) on the last level generated */
+u16b gen_vaults = 0; /* Vaults on the last level generated */
+
 /*
  *  Most of the extra Sil variables...
  */
@@ -340,9 +344,10 @@ s16b (*cave_m_idx)[MAX_DUNGEON_WID];
 u32b mon_power_ave[MAX_DEPTH][CREATURE_TYPE_MAX];
 
 /*
- * Arrays[NUM_FLOWS][DUNGEON_HGT][DUNGEON_WID] of cave grid flow "cost" values
+ * Array[MAX_FLOWS] of pointers to Arrays[DUNGEON_HGT][DUNGEON_WID] of cave
+ * grid flow "cost" values (see the flow pool in "cave.c")
  */
-byte cave_cost[MAX_FLOWS][MAX_DUNGEON_HGT][MAX_DUNGEON_WID];
+byte_wid* cave_cost[MAX_FLOWS];
 
 /*
  * Array[DUNGEON_HGT][DUNGEON_WID] of cave grid flow "when" stamps
@@ -428,6 +433,18 @@ s16b alloc_race_size;
  */
 alloc_entry* alloc_race_table;
 
+/*
+ * The cached bands of the kind and race allocator tables
+ */
+alloc_band* alloc_kind_band;
+alloc_band* alloc_race_band;
+
+/*
+ * Allocator stamps, bumped whenever the cached bands go stale
+ */
+u32b alloc_kind_stamp;
+u32b alloc_race_stamp;
+
 /*
  * Specify attr/char pairs for visual special effects
  * Be sure to use "index & 0xFF" to avoid illegal access
@@ -1246,6 +1246,12 @@ static void do_cmd_wiz_tile_test(void)
     for (int i = 2; i < 7; ++i)
         cave_info[3][i] = CAVE_WALL;
 
+    /* The noise flows must be rebuilt from scratch */
+    forget_flows();
+
+    /* No remembered lines of sight */
+    los_cache_forget();
+
     for (int i = 1; i < mon_max; i++)
     {
         monster_type* m_ptr = &mon_list[i];
@@ -1764,6 +1770,121 @@ void do_cmd_wiz_look(void)
     target_set_interactive(TARGET_WIZ, 0);
 }
 
+/*
+ * Show how well the "los()" cache has been doing
+ */
+static void do_cmd_wiz_los_cache(void)
+{
+    u32b hits, misses, resets;
+    u32b total;
+
+    los_cache_stats(&hits, &misses, &resets);
+
+    total = hits + misses;
+
+    msg_format("LOS cache: %lu hits, %lu misses (%lu%% hits), %lu resets.",
+        (unsigned long)hits, (unsigned long)misses,
+        total ? (unsigned long)((hits * 100.0) / total) : 0UL,
+        (unsigned long)resets);
+}
+
+#ifdef ALLOW_PROFILE
+
+/*
+ * Write the profiling counters to "profile.csv" in the user directory
+ */
+static void wiz_profile_dump(void)
+{
+    int n;
+
+    FILE* fff;
+
+    char buf[1024];
+
+    /* Build the filename */
+    path_build(buf, sizeof(buf), ANGBAND_DIR_USER, "profile.csv");
+
+    /* File type is "TEXT" */
+    FILE_TYPE(FILE_TYPE_TEXT);
+
+    /* Open the file */
+    fff = my_fopen(buf, "w");
+
+    /* Failure */
+    if (!fff)
+    {
+        msg_format("Could not write %s.", buf);
+        return;
+    }
+
+    fprintf(fff, "subsystem,calls,total_us,mean_us\n");
+
+    for (n = 0; n < PROF_MAX; n++)
+    {
+        fprintf(fff, "%s,%lu,%.0f,%.2f\n", prof_name[n],
+            (unsigned long)prof_calls[n], prof_time[n],
+            prof_calls[n] ? prof_time[n] / prof_calls[n] : 0.0);
+    }
+
+    my_fclose(fff);
+
+    msg_format("Profile written to %s.", buf);
+}
+
+/*
+ * Show the profiling counters, until escape
+ */
+static void do_cmd_wiz_profile(void)
+{
+    int n;
+
+    char ch;
+
+    double total;
+
+    /* Save screen */
+    screen_save();
+
+    while (TRUE)
+    {
+        /* Sum of all the subsystems (which may overlap) */
+        total = 0.0;
+        for (n = 0; n < PROF_MAX; n++)
+            total += prof_time[n];
+
+        Term_clear();
+
+        c_prt(TERM_L_BLUE,
+            format("%-16s %10s %12s %10s %6s", "Subsystem", "Calls",
+                "Total (ms)", "Mean (us)", "Share"),
+            1, 2);
+
+        for (n = 0; n < PROF_MAX; n++)
+        {
+            prt(format("%-16s %10lu %12.1f %10.2f %5.1f%%", prof_name[n],
+                    (unsigned long)prof_calls[n], prof_time[n] / 1000.0,
+                    prof_calls[n] ? prof_time[n] / prof_calls[n] : 0.0,
+                    total > 0.0 ? (prof_time[n] * 100.0) / total : 0.0),
+                3 + n, 2);
+        }
+
+        /* Get choice (other keys just refresh the table) */
+        if (!get_com("[r]eset [d]ump to profile.csv, or ESC: ", &ch))
+            break;
+
+        if ((ch == 'r') || (ch == 'R'))
+            prof_reset();
+
+        if ((ch == 'd') || (ch == 'D'))
+            wiz_profile_dump();
+    }
+
+    /* Load screen */
+    screen_load();
+}
+
+#endif /* ALLOW_PROFILE */
+
 /*
  * Ask for and parse a "debug command"
  *
@@ -1899,6 +2020,13 @@ void do_cmd_debug(void)
         break;
     }
 
+    /* Line of sight cache statistics */
+    case 'L':
+    {
+        do_cmd_wiz_los_cache();
+        break;
+    }
+
     /* Magic Mapping */
     case 'm':
     {
@@ -1906,6 +2034,17 @@ void do_cmd_debug(void)
         break;
     }
 
+#ifdef ALLOW_PROFILE
+
+    /* Profiling counters */
+    case 'P':
+    {
+        do_cmd_wiz_profile();
+        break;
+    }
+
+#endif /* ALLOW_PROFILE */
+
     /* Summon Named Monster */
     case 'n':
     {
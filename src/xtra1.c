@@ -314,6 +314,8 @@ static void prt_stat(int stat)
 static void prt_exp(void)
 {
     char out_val[32];
+    char buf[32];
+    sbuf sb;
     byte attr;
 
     attr = TERM_L_GREEN;
@@ -323,7 +325,11 @@ static void prt_exp(void)
 
     comma_number(out_val, p_ptr->new_exp);
 
-    c_put_str(attr, format("%8s", out_val), ROW_EXP, COL_EXP + 4);
+    sbuf_init(&sb, buf, sizeof(buf));
+    sbuf_str(&sb, out_val);
+    sbuf_right(&sb, 8);
+
+    c_put_str(attr, buf, ROW_EXP, COL_EXP + 4);
 }
 
 /*
@@ -332,6 +338,7 @@ static void prt_exp(void)
 static void prt_mel(void)
 {
     char buf[32];
+    sbuf sb;
     int mod = 0;
 
     if (((&inventory[INVEN_ARM])->k_idx)
@@ -341,9 +348,11 @@ static void prt_mel(void)
     /* Melee attacks */
     int meleeColour
         = p_ptr->active_ability[S_MEL][MEL_SMITE] ? TERM_L_RED : TERM_L_WHITE;
-    strnfmt(buf, sizeof(buf), "(%+d,%dd%d)", p_ptr->skill_use[S_MEL],
-        p_ptr->mdd, p_ptr->mds);
-    Term_putstr(COL_MEL, ROW_MEL + mod, -1, meleeColour, format("%12s", buf));
+    sbuf_init(&sb, buf, sizeof(buf));
+    sbuf_fmt(&sb, "(%+d,%dd%d)", p_ptr->skill_use[S_MEL], p_ptr->mdd,
+        p_ptr->mds);
+    sbuf_right(&sb, 12);
+    Term_putstr(COL_MEL, ROW_MEL + mod, -1, meleeColour, buf);
 
     if (p_ptr->active_ability[S_MEL][MEL_RAPID_ATTACK])
     {
@@ -352,15 +361,16 @@ static void prt_mel(void)
 
     if (mod == -1)
     {
-        strnfmt(buf, sizeof(buf), "(%+d,%dd%d)",
+        sbuf_init(&sb, buf, sizeof(buf));
+        sbuf_fmt(&sb, "(%+d,%dd%d)",
             p_ptr->skill_use[S_MEL] + p_ptr->offhand_mel_mod, p_ptr->mdd2,
             p_ptr->mds2);
-        Term_putstr(COL_MEL, ROW_MEL, -1, TERM_L_WHITE, format("%12s", buf));
+        sbuf_right(&sb, 12);
+        Term_putstr(COL_MEL, ROW_MEL, -1, TERM_L_WHITE, buf);
     }
     else
     {
-        strnfmt(buf, sizeof(buf), "            ");
-        Term_putstr(COL_MEL, ROW_MEL - 1, -1, TERM_L_BLUE, format("%12s", buf));
+        Term_putstr(COL_MEL, ROW_MEL - 1, -1, TERM_L_BLUE, "            ");
     }
 }
 
@@ -370,6 +380,7 @@ static void prt_mel(void)
 static void prt_arc(void)
 {
     char buf[32];
+    sbuf sb;
 
     /* Range attacks */
     if ((&inventory[INVEN_BOW])->k_idx)
@@ -377,29 +388,32 @@ static void prt_arc(void)
         if (p_ptr->active_ability[S_ARC][ARC_DEADLY_HAIL]
             && p_ptr->killed_enemy_with_arrow)
         {
-            strnfmt(buf, sizeof(buf), ")");
-            Term_putstr(COL_ARC, ROW_ARC, -1, TERM_UMBER, format("%12s", buf));
-            strnfmt(buf, sizeof(buf), "%dd%d", 2 * p_ptr->add, p_ptr->ads);
-            Term_putstr(COL_ARC, ROW_ARC, -1, TERM_RED, format("%11s", buf));
-            strnfmt(buf, sizeof(buf), "(%+d,", p_ptr->skill_use[S_ARC]);
-            if (p_ptr->ads > 9)
-                Term_putstr(
-                    COL_ARC, ROW_ARC, -1, TERM_UMBER, format("%7s", buf));
-            else
-                Term_putstr(
-                    COL_ARC, ROW_ARC, -1, TERM_UMBER, format("%8s", buf));
+            Term_putstr(COL_ARC, ROW_ARC, -1, TERM_UMBER, "           )");
+            sbuf_init(&sb, buf, sizeof(buf));
+            sbuf_num(&sb, 2 * p_ptr->add, FALSE);
+            sbuf_chr(&sb, 'd');
+            sbuf_num(&sb, p_ptr->ads, FALSE);
+            sbuf_right(&sb, 11);
+            Term_putstr(COL_ARC, ROW_ARC, -1, TERM_RED, buf);
+            sbuf_init(&sb, buf, sizeof(buf));
+            sbuf_chr(&sb, '(');
+            sbuf_num(&sb, p_ptr->skill_use[S_ARC], TRUE);
+            sbuf_chr(&sb, ',');
+            sbuf_right(&sb, (p_ptr->ads > 9) ? 7 : 8);
+            Term_putstr(COL_ARC, ROW_ARC, -1, TERM_UMBER, buf);
         }
         else
         {
-            strnfmt(buf, sizeof(buf), "(%+d,%dd%d)", p_ptr->skill_use[S_ARC],
-                p_ptr->add, p_ptr->ads);
-            Term_putstr(COL_ARC, ROW_ARC, -1, TERM_UMBER, format("%12s", buf));
+            sbuf_init(&sb, buf, sizeof(buf));
+            sbuf_fmt(&sb, "(%+d,%dd%d)", p_ptr->skill_use[S_ARC], p_ptr->add,
+                p_ptr->ads);
+            sbuf_right(&sb, 12);
+            Term_putstr(COL_ARC, ROW_ARC, -1, TERM_UMBER, buf);
         }
     }
     else
     {
-        strnfmt(buf, sizeof(buf), "            ");
-        Term_putstr(COL_ARC, ROW_ARC, -1, TERM_L_BLUE, format("%12s", buf));
+        Term_putstr(COL_ARC, ROW_ARC, -1, TERM_L_BLUE, "            ");
     }
 }
 
@@ -409,15 +423,18 @@ static void prt_arc(void)
 static void prt_evn(void)
 {
     char buf[32];
+    sbuf sb;
 
     // Toggle blocking on and off so we don't show the blocking value in
     // the armor total
     bool block = p_ptr->active_ability[S_EVN][EVN_BLOCKING];
     p_ptr->active_ability[S_EVN][EVN_BLOCKING] = FALSE;
     /* Total Armor */
-    strnfmt(buf, sizeof(buf), "[%+d,%d-%d]", p_ptr->skill_use[S_EVN],
+    sbuf_init(&sb, buf, sizeof(buf));
+    sbuf_fmt(&sb, "[%+d,%d-%d]", p_ptr->skill_use[S_EVN],
         p_min(GF_HURT, TRUE), p_max(GF_HURT, TRUE));
-    Term_putstr(COL_EVN, ROW_EVN, -1, TERM_SLATE, format("%12s", buf));
+    sbuf_right(&sb, 12);
+    Term_putstr(COL_EVN, ROW_EVN, -1, TERM_SLATE, buf);
     p_ptr->active_ability[S_EVN][EVN_BLOCKING] = block;
 }
 
@@ -532,15 +549,19 @@ static void prt_song(void)
 static void prt_depth(void)
 {
     char depths[32];
+    sbuf sb;
     s16b attr = TERM_WHITE;
 
+    sbuf_init(&sb, depths, sizeof(depths));
+
     if (!p_ptr->depth)
     {
-        my_strcpy(depths, "Surface", sizeof(depths));
+        sbuf_str(&sb, "Surface");
     }
     else
     {
-        sprintf(depths, "%d ft", p_ptr->depth * 50);
+        sbuf_num(&sb, p_ptr->depth * 50, FALSE);
+        sbuf_str(&sb, " ft");
     }
 
     /* Get color of level based on feeling  -JSV- */
@@ -571,7 +592,8 @@ static void prt_depth(void)
     }
 
     /* Right-Adjust the "depth", and clear old values */
-    c_prt(attr, format("%7s", depths), ROW_DEPTH, COL_DEPTH);
+    sbuf_right(&sb, 7);
+    c_prt(attr, depths, ROW_DEPTH, COL_DEPTH);
 }
 
 /*
@@ -856,24 +878,24 @@ static void prt_speed(void)
     int i = p_ptr->pspeed;
 
     byte attr = TERM_WHITE;
-    char buf[32] = "";
+    cptr str = "    ";
 
     /* Fast */
     if (i > 2)
     {
         attr = TERM_L_GREEN;
-        sprintf(buf, "Fast");
+        str = "Fast";
     }
 
     /* Slow */
     else if (i < 2)
     {
         attr = TERM_ORANGE;
-        sprintf(buf, "Slow");
+        str = "Slow";
     }
 
     /* Display the speed */
-    c_put_str(attr, format("%-4s", buf), ROW_SPEED, COL_SPEED);
+    c_put_str(attr, str, ROW_SPEED, COL_SPEED);
 }
 
 /*
@@ -2181,6 +2203,8 @@ static void calc_bonuses(void)
 
     int armour_weight = 0;
 
+    PROF_ENTER(PROF_CALC_BONUSES);
+
     // Remove off-hand weapons if you cannot wield them
     if (!p_ptr->active_ability[S_MEL][MEL_TWO_WEAPON])
     {
@@ -3042,11 +3066,16 @@ static void calc_bonuses(void)
 
     /* Hack -- handle "xtra" mode */
     if (character_xtra)
+    {
+        PROF_LEAVE(PROF_CALC_BONUSES);
         return;
+    }
 
     // identify {special} items when the type has been seen before
     id_known_specials();
     reorder_pack(FALSE);
+
+    PROF_LEAVE(PROF_CALC_BONUSES);
 }
 
 /*
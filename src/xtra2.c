@@ -2337,6 +2337,9 @@ void monster_death(int m_idx)
     if (r_ptr->flags1 & (RF1_UNIQUE))
     {
         r_ptr->max_num = 0;
+
+        /* The race may no longer be allocated */
+        alloc_race_stamp++;
     }
 
     /* Count kills this life */
@@ -127,6 +127,75 @@
  * character capitilized, if reasonable.
  */
 
+/*
+ * Write the number "v" (with a "+" if "plus" is set and "v" is not
+ * negative) into "tmp", which must hold at least 24 chars
+ */
+static size_t strnfmt_num(char* tmp, long v, bool plus)
+{
+    char digits[24];
+    unsigned long u = (v < 0) ? -(unsigned long)v : (unsigned long)v;
+    size_t n = 0, k = 0;
+
+    /* Collect the digits, backwards */
+    do
+    {
+        digits[k++] = (char)('0' + (u % 10));
+        u /= 10;
+    } while (u);
+
+    /* The sign */
+    if (v < 0)
+        tmp[n++] = '-';
+    else if (plus)
+        tmp[n++] = '+';
+
+    /* The digits */
+    while (k)
+        tmp[n++] = digits[--k];
+
+    tmp[n] = '\0';
+
+    return (n);
+}
+
+/*
+ * Is the format sequence "aux" (of length "q") a "plain" one, with only
+ * the "-" and "+" flags and a width, and a "d", "i" or "s" (not "long")?
+ */
+static bool strnfmt_plain(cptr aux, size_t q, bool* left, bool* plus,
+    size_t* width)
+{
+    size_t i = 1;
+
+    char f = aux[q - 1];
+
+    *left = *plus = FALSE;
+    *width = 0;
+
+    /* Only numbers and strings */
+    if ((f != 'd') && (f != 'i') && (f != 's'))
+        return (FALSE);
+
+    /* Flags */
+    for (; (aux[i] == '-') || (aux[i] == '+'); i++)
+    {
+        if (aux[i] == '-')
+            *left = TRUE;
+        else
+            *plus = TRUE;
+    }
+
+    /* Width (but not "zero padding") */
+    if (aux[i] == '0')
+        return (FALSE);
+    for (; isdigit((unsigned char)aux[i]); i++)
+        *width = *width * 10 + (aux[i] - '0');
+
+    /* Nothing else (and no "+" on strings) */
+    return ((i == q - 1) && !(*plus && (f == 's')));
+}
+
 /*
  * Basic "vararg" format function.
  *
@@ -176,6 +245,10 @@
  * if an error is detected in the format string, we simply "pre-terminate"
  * the given buffer to a length of zero, and return a "length" of zero.
  * The contents of "buf", except for "buf[0]", may then be undefined.
+ *
+ * The most common format sequences (numbers and strings with at most a
+ * width and the "-" and "+" flags) are written straight into "buf",
+ * instead of through "sprintf()" and two temporary copies.
  */
 size_t vstrnfmt(char* buf, size_t max, cptr fmt, va_list vp)
 {
@@ -193,6 +266,10 @@ size_t vstrnfmt(char* buf, size_t max, cptr fmt, va_list vp)
     /* Bytes used in format sequence */
     size_t q;
 
+    /* Flags and width of a "plain" format sequence */
+    bool left, plus;
+    size_t width;
+
     /* Format sequence */
     char aux[128];
 
@@ -385,6 +462,55 @@ size_t vstrnfmt(char* buf, size_t max, cptr fmt, va_list vp)
         /* Terminate "aux" */
         aux[q] = '\0';
 
+        /* Handle "plain" numbers and strings directly */
+        if (!do_long && strnfmt_plain(aux, q, &left, &plus, &width))
+        {
+            cptr arg = tmp;
+            size_t len;
+
+            /* Get the next argument */
+            if (aux[q - 1] == 's')
+            {
+                arg = va_arg(vp, cptr);
+
+                /* Hack -- convert NULL to EMPTY */
+                if (!arg)
+                    arg = "";
+
+                len = strlen(arg);
+            }
+            else
+            {
+                len = strnfmt_num(tmp, va_arg(vp, int), plus);
+            }
+
+            /* Pad on the left */
+            for (; !left && (width > len) && (n < max - 1); width--)
+                buf[n++] = ' ';
+
+            /* Append the argument */
+            for (q = 0; arg[q] && (n < max - 1); q++)
+            {
+                buf[n++] = arg[q];
+
+                /* Mega-Hack -- handle "capitalization" */
+                if (do_xtra && !isspace((unsigned char)arg[q]))
+                {
+                    if (islower((unsigned char)arg[q]))
+                        buf[n - 1] = toupper((unsigned char)arg[q]);
+
+                    do_xtra = FALSE;
+                }
+            }
+
+            /* Pad on the right */
+            for (; left && (width > len) && (n < max - 1); width--)
+                buf[n++] = ' ';
+
+            /* Continue */
+            continue;
+        }
+
         /* Clear "tmp" */
         tmp[0] = '\0';
 
@@ -686,6 +812,99 @@ char* format(cptr fmt, ...)
     return (res);
 }
 
+/*
+ * Start building a string in "buf" (of size "max")
+ */
+void sbuf_init(sbuf* sb, char* buf, size_t max)
+{
+    /* Fatal error - no buffer length */
+    if (!max)
+        quit("Called sbuf_init() with empty buffer!");
+
+    sb->buf = buf;
+    sb->max = max;
+    sb->len = 0;
+
+    buf[0] = '\0';
+}
+
+/*
+ * Append the string "s"
+ */
+void sbuf_str(sbuf* sb, cptr s)
+{
+    while (*s && (sb->len < sb->max - 1))
+        sb->buf[sb->len++] = *s++;
+
+    sb->buf[sb->len] = '\0';
+}
+
+/*
+ * Append the character "c"
+ */
+void sbuf_chr(sbuf* sb, char c)
+{
+    if (sb->len < sb->max - 1)
+        sb->buf[sb->len++] = c;
+
+    sb->buf[sb->len] = '\0';
+}
+
+/*
+ * Append the number "n", as "%ld" (or "%+ld" if "plus" is set)
+ */
+void sbuf_num(sbuf* sb, long n, bool plus)
+{
+    char tmp[24];
+
+    (void)strnfmt_num(tmp, n, plus);
+
+    sbuf_str(sb, tmp);
+}
+
+/*
+ * Append a formatted string (see above)
+ *
+ * The compiler checks the arguments against the format string where it
+ * can, so only the standard "printf()" format sequences should be used.
+ */
+void sbuf_fmt(sbuf* sb, cptr fmt, ...)
+{
+    va_list vp;
+
+    /* Begin the Varargs Stuff */
+    va_start(vp, fmt);
+
+    /* Append the string */
+    sb->len += vstrnfmt(sb->buf + sb->len, sb->max - sb->len, fmt, vp);
+
+    /* End the Varargs Stuff */
+    va_end(vp);
+}
+
+/*
+ * Pad the string with spaces (on the left) to "width" chars, as "%*s"
+ */
+void sbuf_right(sbuf* sb, size_t width)
+{
+    size_t shift;
+
+    /* Stay inside the buffer */
+    if (width > sb->max - 1)
+        width = sb->max - 1;
+
+    /* Already wide enough */
+    if (sb->len >= width)
+        return;
+
+    /* Move the string (and the terminator) to the right */
+    shift = width - sb->len;
+    memmove(sb->buf + shift, sb->buf, sb->len + 1);
+    memset(sb->buf, ' ', shift);
+
+    sb->len = width;
+}
+
 /*
  * Vararg interface to plog()
  */
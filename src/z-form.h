@@ -24,6 +24,30 @@
  * This file makes use of both "z-util.c" and "z-virt.c"
  */
 
+/*
+ * Check the arguments of a function which takes a standard "printf()"
+ * format string (where the compiler knows how), so the "special" format
+ * sequences (see "z-form.c") must not be used with these functions
+ */
+#ifdef __GNUC__
+#define ZFORM_CHECK(F, A) __attribute__((format(printf, F, A)))
+#else /* __GNUC__ */
+#define ZFORM_CHECK(F, A)
+#endif /* __GNUC__ */
+
+/*
+ * A string builder, which appends to a buffer supplied by the caller
+ * (usually on the stack), without any static or allocated memory
+ */
+typedef struct sbuf sbuf;
+
+struct sbuf
+{
+    char* buf; /* The buffer */
+    size_t max; /* Size of the buffer */
+    size_t len; /* Length of the string so far */
+};
+
 /**** Available Functions ****/
 
 /* Format arguments into given bounded-length buffer */
@@ -44,6 +68,24 @@ extern void strnfcat(char* str, size_t max, size_t* end, cptr fmt, ...);
 /* Simple interface to "vformat()" */
 extern char* format(cptr fmt, ...);
 
+/* Start building a string in the given buffer */
+extern void sbuf_init(sbuf* sb, char* buf, size_t max);
+
+/* Append a string to a string builder */
+extern void sbuf_str(sbuf* sb, cptr s);
+
+/* Append a character to a string builder */
+extern void sbuf_chr(sbuf* sb, char c);
+
+/* Append a number (with a "+" if "plus" is set) to a string builder */
+extern void sbuf_num(sbuf* sb, long n, bool plus);
+
+/* Append a formatted string (standard sequences only) to a string builder */
+extern void sbuf_fmt(sbuf* sb, cptr fmt, ...) ZFORM_CHECK(2, 3);
+
+/* Right-justify the string in a string builder to a total width */
+extern void sbuf_right(sbuf* sb, size_t width);
+
 /* Vararg interface to "plog()", using "format()" */
 extern void plog_fmt(cptr fmt, ...);
 
@@ -12,8 +12,18 @@
 
 #include "z-term.h"
 
+#include "z-util.h"
 #include "z-virt.h"
 
+/*
+ * Use SSE2 for the row diff where the compiler is sure to have it
+ */
+#if defined(__SSE2__) || defined(_M_X64)                                       \
+    || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define TERM_SSE2
+#include <emmintrin.h>
+#endif
+
 /*
  * This file provides a generic, efficient, terminal window package,
  * which can be used not only on standard terminal environments such
@@ -188,6 +198,7 @@
  *   Term->wipe_hook = Draw some blank spaces
  *   Term->text_hook = Draw some text in the window
  *   Term->pict_hook = Draw some attr/chars in the window
+ *   Term->span_hook = Draw a whole changed span of attr/chars
  *
  * The "Term->user_hook" hook provides a simple hook to an implementation
  * defined function, with application defined semantics.  It is available
@@ -234,6 +245,17 @@
  * the terrain values as a background and the "ap", "cp" values in
  * the foreground.
  *
+ * The "Term->span_hook" hook provides this package with a way to draw,
+ * starting at "x,y", the "n" attr/char pairs contained in "ap" and "cp"
+ * as text, each grid in its own attr.  Grids with a zero attr should be
+ * erased, as by "Term->wipe_hook", unless "always_text" is set.  This
+ * hook is optional.  When present, "Term_fresh()" sends every grid from
+ * the first changed one to the last changed one in a row in a single
+ * call, instead of one "Term->text_hook" call per run of one colour,
+ * so it should only change the colour when the attr actually changes.
+ * High-bit attr/char pairs still go to "Term->pict_hook" when the
+ * "higher_pict" flag is set, and break the span.
+ *
  * The game "Angband" uses a set of files called "main-xxx.c", for
  * various "xxx" suffixes.  Most of these contain a function called
  * "init_xxx()", that will prepare the underlying visual system for
@@ -572,8 +594,757 @@ void Term_queue_chars(int x, int y, int n, byte a, cptr s)
     }
 }
 
+/*** Recording routines ***/
+
+/*
+ * A recording is a stream of the refreshes of one term, which can be
+ * played back (by "Term_replay()") at any speed without running any of
+ * the game.  After an eight byte header ("SREC", a version, and three
+ * spare bytes) it is a list of records, each of which is a type byte
+ * and a time stamp (in milliseconds since the start, four bytes), and:
+ *
+ *	'K' (keyframe) -- width, height (two bytes each), the cursor (four
+ *	    bytes), and then every grid of the screen, as runs of up to 255
+ *	    identical grids (a count, then attr, char, terrain attr and char)
+ *
+ *	'F' (frame) -- the cursor (four bytes), the number of spans (two
+ *	    bytes), and then each span (row, column and length, two bytes
+ *	    each, then attr, char, terrain attr and char for each grid)
+ *
+ *	'P' (keypress) -- the key (two bytes)
+ *
+ * All multi-byte numbers are stored low byte first.  A frame holds only
+ * the grids which really changed in that call to "Term_fresh()", and a
+ * keyframe is stored on every "total erase", and every so often, so that
+ * a player can seek through a recording.
+ */
+
+/*
+ * Number of frames, or milliseconds, between keyframes
+ */
+#define TERM_REC_KEY_FRAMES 500
+#define TERM_REC_KEY_MSEC 10000
+
+/*
+ * The longest idle period which is played back, in milliseconds
+ */
+#define TERM_REC_IDLE_MSEC 1000
+
+static FILE* rec_fp; /* The recording (or NULL) */
+static term* rec_term; /* The term which is being recorded */
+static double rec_start; /* Wall clock when the recording began (msec) */
+static u32b rec_key_time; /* Time stamp of the last keyframe */
+static int rec_frames; /* Frames since the last keyframe */
+
+static byte* rec_buf; /* The record being built */
+static size_t rec_len; /* Length of that record */
+static size_t rec_max; /* Size of the buffer */
+static size_t rec_count; /* Offset of the span count of a frame */
+static int rec_spans; /* Number of spans in that frame */
+
+/*
+ * Make room for "n" more bytes in the record being built
+ */
+static void Term_record_room(size_t n)
+{
+    byte* buf;
+
+    /* Already enough room */
+    if (rec_len + n <= rec_max)
+        return;
+
+    /* Grow the buffer */
+    while (rec_len + n > rec_max)
+        rec_max *= 2;
+
+    /* Move the record */
+    C_MAKE(buf, rec_max, byte);
+    C_COPY(buf, rec_buf, rec_len, byte);
+    FREE(rec_buf);
+    rec_buf = buf;
+}
+
+/*
+ * Add a number of "n" bytes to the record being built
+ */
+static void Term_record_num(u32b v, int n)
+{
+    for (; n > 0; n--, v >>= 8)
+        rec_buf[rec_len++] = (byte)(v & 0xFF);
+}
+
+/*
+ * Add grid "x" of row "y" (in "scr") to the record being built
+ */
+static void Term_record_grid(int x, int y)
+{
+    term_win* scr = Term->scr;
+
+    rec_buf[rec_len++] = scr->a[y][x];
+    rec_buf[rec_len++] = (byte)scr->c[y][x];
+    rec_buf[rec_len++] = scr->ta[y][x];
+    rec_buf[rec_len++] = (byte)scr->tc[y][x];
+}
+
+/*
+ * Begin a record of type "t"
+ */
+static void Term_record_begin(int t)
+{
+    rec_len = 0;
+
+    Term_record_room(5);
+    Term_record_num(t, 1);
+    Term_record_num((u32b)(clock_msec() - rec_start), 4);
+}
+
+/*
+ * Add the cursor (in "scr") to the record being built
+ */
+static void Term_record_cursor(void)
+{
+    term_win* scr = Term->scr;
+
+    Term_record_room(4);
+    Term_record_num(scr->cu, 1);
+    Term_record_num(scr->cv, 1);
+    Term_record_num(scr->cx, 1);
+    Term_record_num(scr->cy, 1);
+}
+
+/*
+ * Write out the record which has been built
+ */
+static void Term_record_end(void)
+{
+    if (fwrite(rec_buf, 1, rec_len, rec_fp) != rec_len)
+        (void)Term_record_stop();
+}
+
+/*
+ * Record the start of a frame, which is a keyframe (whose grids are only
+ * added at the end) after a "total erase", or every so often
+ */
+static bool Term_record_frame(void)
+{
+    bool key = (Term->total_erase || (rec_frames >= TERM_REC_KEY_FRAMES)
+        || (clock_msec() - rec_start - rec_key_time >= TERM_REC_KEY_MSEC));
+
+    Term_record_begin(key ? 'K' : 'F');
+
+    /* A keyframe */
+    if (key)
+    {
+        Term_record_room(4);
+        Term_record_num(Term->wid, 2);
+        Term_record_num(Term->hgt, 2);
+        Term_record_cursor();
+
+        /* Remember */
+        rec_key_time = (u32b)(clock_msec() - rec_start);
+        rec_frames = 0;
+    }
+
+    /* A frame */
+    else
+    {
+        Term_record_cursor();
+
+        /* Leave room for the span count */
+        Term_record_room(2);
+        rec_count = rec_len;
+        rec_len += 2;
+        rec_spans = 0;
+
+        /* Count it */
+        rec_frames++;
+    }
+
+    return (key);
+}
+
+/*
+ * Record the grids "x1" to "x2" of row "y" in the current frame
+ */
+static void Term_record_span(int y, int x1, int x2)
+{
+    int x;
+
+    Term_record_room(6 + (x2 - x1 + 1) * 4);
+    Term_record_num(y, 2);
+    Term_record_num(x1, 2);
+    Term_record_num(x2 - x1 + 1, 2);
+
+    for (x = x1; x <= x2; x++)
+        Term_record_grid(x, y);
+
+    rec_spans++;
+}
+
+/*
+ * Finish the current frame, adding every grid to a keyframe
+ */
+static void Term_record_flush(bool key)
+{
+    int x, y;
+
+    term_win* scr = Term->scr;
+
+    /* A keyframe */
+    if (key)
+    {
+        int n = 0;
+
+        Term_record_room(Term->wid * Term->hgt * 5);
+
+        /* Collect runs of identical grids */
+        for (y = 0; y < Term->hgt; y++)
+        {
+            for (x = 0; x < Term->wid; x++)
+            {
+                /* Extend the run */
+                if (n && (n < 255) && (scr->a[y][x] == rec_buf[rec_len - 4])
+                    && ((byte)scr->c[y][x] == rec_buf[rec_len - 3])
+                    && (scr->ta[y][x] == rec_buf[rec_len - 2])
+                    && ((byte)scr->tc[y][x] == rec_buf[rec_len - 1]))
+                {
+                    rec_buf[rec_len - 5] = ++n;
+                    continue;
+                }
+
+                /* Start a new run */
+                rec_buf[rec_len++] = n = 1;
+                Term_record_grid(x, y);
+            }
+        }
+    }
+
+    /* A frame */
+    else
+    {
+        rec_buf[rec_count] = (byte)(rec_spans & 0xFF);
+        rec_buf[rec_count + 1] = (byte)(rec_spans >> 8);
+    }
+
+    Term_record_end();
+}
+
+/*
+ * Record the keypress "k"
+ */
+static void Term_record_key(int k)
+{
+    Term_record_begin('P');
+    Term_record_room(2);
+    Term_record_num((u32b)k & 0xFFFF, 2);
+    Term_record_end();
+}
+
+/*
+ * Start recording the current term into "fp", which has been opened
+ * for binary writing, and is closed by "Term_record_stop()"
+ */
+errr Term_record_start(FILE* fp)
+{
+    static const byte head[8] = { 'S', 'R', 'E', 'C', 1, 0, 0, 0 };
+
+    /* Stop any old recording */
+    if (rec_fp)
+        (void)Term_record_stop();
+
+    /* Write the header */
+    if (fwrite(head, 1, sizeof(head), fp) != sizeof(head))
+        return (-1);
+
+    /* Prepare the buffer */
+    rec_max = 1024;
+    C_MAKE(rec_buf, rec_max, byte);
+
+    /* Remember */
+    rec_fp = fp;
+    rec_term = Term;
+    rec_start = clock_msec();
+
+    /* Start with a keyframe */
+    rec_frames = TERM_REC_KEY_FRAMES;
+    Term->total_erase = TRUE;
+
+    /* Success */
+    return (0);
+}
+
+/*
+ * Stop recording (if needed), and close the recording
+ */
+errr Term_record_stop(void)
+{
+    /* Not recording */
+    if (!rec_fp)
+        return (1);
+
+    /* Close the file */
+    (void)fclose(rec_fp);
+    rec_fp = NULL;
+    rec_term = NULL;
+
+    /* Free the buffer */
+    FREE(rec_buf);
+    rec_buf = NULL;
+    rec_max = 0;
+
+    /* Success */
+    return (0);
+}
+
+/*
+ * Read a number of "n" bytes from "buf"
+ */
+static u32b Term_replay_num(const byte* buf, int n)
+{
+    u32b v = 0;
+
+    while (n-- > 0)
+        v = (v << 8) | buf[n];
+
+    return (v);
+}
+
+/*
+ * Show a grid (if it is on the screen) from the four bytes "p"
+ */
+static void Term_replay_grid(int x, int y, const byte* p)
+{
+    term_win* scr = Term->scr;
+
+    /* Ignore grids off the screen */
+    if ((x >= Term->wid) || (y >= Term->hgt))
+        return;
+
+    /* Save the grid */
+    scr->a[y][x] = p[0];
+    scr->c[y][x] = (char)p[1];
+    scr->ta[y][x] = p[2];
+    scr->tc[y][x] = (char)p[3];
+
+    /* Check for new min/max row info */
+    if (y < Term->y1)
+        Term->y1 = y;
+    if (y > Term->y2)
+        Term->y2 = y;
+
+    /* Check for new min/max col info for this row */
+    if (x < Term->x1[y])
+        Term->x1[y] = x;
+    if (x > Term->x2[y])
+        Term->x2[y] = x;
+}
+
+/*
+ * Show the cursor from the four bytes "p"
+ */
+static void Term_replay_cursor(const byte* p)
+{
+    term_win* scr = Term->scr;
+
+    scr->cu = (p[2] >= Term->wid) || (p[3] >= Term->hgt) || p[0];
+    scr->cv = p[1];
+    scr->cx = MIN(p[2], Term->wid - 1);
+    scr->cy = MIN(p[3], Term->hgt - 1);
+}
+
+/*
+ * Find the end of the record at "pos" in "buf" (of length "len"), and
+ * show it if "show" is set, or return 0 if it is damaged
+ */
+static size_t Term_replay_record(const byte* buf, size_t len, size_t pos,
+    bool show)
+{
+    const byte* p = buf + pos + 5;
+    const byte* end = buf + len;
+
+    int i, n, x, y, w, h;
+
+    /* Paranoia -- missing time stamp */
+    if (pos + 5 > len)
+        return (0);
+
+    switch (buf[pos])
+    {
+    case 'K':
+    {
+        if (end - p < 8)
+            return (0);
+
+        w = Term_replay_num(p, 2);
+        h = Term_replay_num(p + 2, 2);
+
+        /* Start from a blank screen */
+        if (show)
+        {
+            Term_clear();
+            Term_replay_cursor(p + 4);
+        }
+
+        p += 8;
+
+        /* Read the runs of grids */
+        for (i = 0; i < w * h; i += n)
+        {
+            if ((end - p < 5) || !p[0])
+                return (0);
+
+            for (n = 0; show && (n < p[0]) && (i + n < w * h); n++)
+                Term_replay_grid((i + n) % w, (i + n) / w, p + 1);
+
+            n = p[0];
+            p += 5;
+        }
+
+        break;
+    }
+
+    case 'F':
+    {
+        if (end - p < 6)
+            return (0);
+
+        if (show)
+            Term_replay_cursor(p);
+
+        i = Term_replay_num(p + 4, 2);
+        p += 6;
+
+        /* Read the spans */
+        for (; i > 0; i--)
+        {
+            if (end - p < 6)
+                return (0);
+
+            y = Term_replay_num(p, 2);
+            x = Term_replay_num(p + 2, 2);
+            n = Term_replay_num(p + 4, 2);
+            p += 6;
+
+            if (end - p < n * 4)
+                return (0);
+
+            for (; show && (n > 0); n--, x++, p += 4)
+                Term_replay_grid(x, y, p);
+
+            p += n * 4;
+        }
+
+        break;
+    }
+
+    case 'P':
+    {
+        if (end - p < 2)
+            return (0);
+
+        p += 2;
+        break;
+    }
+
+    default:
+    {
+        return (0);
+    }
+    }
+
+    return ((size_t)(p - buf));
+}
+
+/*
+ * Play back a recording (see above) in the current term
+ *
+ * The recording is played in real time, skipping long idle periods, and
+ * the player may use '+' and '-' to double or halve the speed, space to
+ * pause, '>' and '<' to seek to the next or previous keyframe, and 'q'
+ * or escape to stop.
+ */
+errr Term_replay(FILE* fp)
+{
+    byte* buf;
+    long size;
+    size_t len, pos, next;
+
+    size_t* key;
+    int keys = 0;
+    int k;
+
+    double now, then;
+    double played = 0.0;
+    int speed = 0;
+    bool pause = FALSE;
+
+    errr result = 0;
+
+    /* Find the length */
+    if (fseek(fp, 0, SEEK_END) || ((size = ftell(fp)) < 8)
+        || fseek(fp, 0, SEEK_SET))
+        return (-1);
+    len = (size_t)size;
+
+    /* Read the recording */
+    C_MAKE(buf, len, byte);
+    if ((fread(buf, 1, len, fp) != len) || strncmp((char*)buf, "SREC", 4)
+        || (buf[4] != 1))
+    {
+        FREE(buf);
+        return (-1);
+    }
+
+    /* Count the keyframes */
+    for (pos = 8; (next = Term_replay_record(buf, len, pos, FALSE)) != 0;
+         pos = next)
+    {
+        if (buf[pos] == 'K')
+            keys++;
+    }
+
+    /* Find the keyframes */
+    C_MAKE(key, keys + 1, size_t);
+    for (k = 0, pos = 8; (next = Term_replay_record(buf, len, pos, FALSE)) != 0;
+         pos = next)
+    {
+        if (buf[pos] == 'K')
+            key[k++] = pos;
+    }
+
+    /* Only play the undamaged records */
+    if (pos < len)
+        result = 1;
+    len = pos;
+
+    /* Start from a blank screen */
+    Term_clear();
+    then = clock_msec();
+
+    for (pos = 8, k = 0; pos < len; pos = next)
+    {
+        u32b t = Term_replay_num(buf + pos + 1, 4);
+        size_t seek = 0;
+        char ch;
+
+        /* Skip long idle periods */
+        if (t > played + TERM_REC_IDLE_MSEC)
+            played = t - TERM_REC_IDLE_MSEC;
+
+        /* Wait until the record is due */
+        while (!seek && (pause || (played < t)))
+        {
+            /* Handle keypresses */
+            if (!Term_inkey(&ch, pause, TRUE))
+            {
+                /* Stop */
+                if ((ch == '\033') || (ch == 'q'))
+                    seek = len;
+
+                /* Pause or continue */
+                else if (ch == ' ')
+                    pause = !pause;
+
+                /* Faster */
+                else if ((ch == '+') && (speed < 8))
+                    speed++;
+
+                /* Slower */
+                else if ((ch == '-') && (speed > -4))
+                    speed--;
+
+                /* Seek back, to the keyframe before the current one */
+                else if ((ch == '<') && (k > 0))
+                    seek = key[(k > 1) ? (k - 2) : 0];
+
+                /* Seek forward, to the next keyframe */
+                else if ((ch == '>') && (k < keys))
+                    seek = key[k];
+            }
+
+            /* Advance the clock, at the chosen speed */
+            now = clock_msec();
+            if (!pause && (speed >= 0))
+                played += (now - then) * (1L << speed);
+            else if (!pause)
+                played += (now - then) / (1L << -speed);
+            then = now;
+
+            /* Sleep a little */
+            if (!seek && (pause || (played < t)))
+                Term_xtra(TERM_XTRA_DELAY, 10);
+        }
+
+        /* Stop */
+        if (seek == len)
+            break;
+
+        /* Seek, and restart the clock there */
+        if (seek)
+        {
+            pos = seek;
+            played = Term_replay_num(buf + pos + 1, 4);
+        }
+
+        /* Show the record */
+        next = Term_replay_record(buf, len, pos, TRUE);
+
+        /* Count the keyframes shown so far */
+        if (buf[pos] == 'K')
+        {
+            for (k = 0; (k < keys) && (key[k] <= pos); k++)
+                /* loop */;
+        }
+
+        /* Refresh */
+        if (buf[pos] != 'P')
+            Term_fresh();
+    }
+
+    FREE(key);
+    FREE(buf);
+
+    return (result);
+}
+
 /*** Refresh routines ***/
 
+/*
+ * Is grid "x" of row "y" the same in "old" and "scr"?  The terrain
+ * planes are only compared if "terrain" is set.
+ */
+static bool Term_fresh_same(int y, int x, bool terrain)
+{
+    term_win* old = Term->old;
+    term_win* scr = Term->scr;
+
+    if ((old->a[y][x] != scr->a[y][x]) || (old->c[y][x] != scr->c[y][x]))
+        return (FALSE);
+
+    if (terrain
+        && ((old->ta[y][x] != scr->ta[y][x])
+            || (old->tc[y][x] != scr->tc[y][x])))
+        return (FALSE);
+
+    return (TRUE);
+}
+
+#ifdef TERM_SSE2
+
+/*
+ * Compare sixteen grids of row "y", starting at "x", in every plane
+ * at once, returning a mask with one bit set per changed grid
+ */
+static int Term_fresh_diff16(int y, int x, bool terrain)
+{
+    term_win* old = Term->old;
+    term_win* scr = Term->scr;
+
+    __m128i d;
+
+    d = _mm_or_si128(
+        _mm_xor_si128(_mm_loadu_si128((const __m128i*)(old->a[y] + x)),
+            _mm_loadu_si128((const __m128i*)(scr->a[y] + x))),
+        _mm_xor_si128(_mm_loadu_si128((const __m128i*)(old->c[y] + x)),
+            _mm_loadu_si128((const __m128i*)(scr->c[y] + x))));
+
+    if (terrain)
+    {
+        d = _mm_or_si128(d,
+            _mm_xor_si128(_mm_loadu_si128((const __m128i*)(old->ta[y] + x)),
+                _mm_loadu_si128((const __m128i*)(scr->ta[y] + x))));
+        d = _mm_or_si128(d,
+            _mm_xor_si128(_mm_loadu_si128((const __m128i*)(old->tc[y] + x)),
+                _mm_loadu_si128((const __m128i*)(scr->tc[y] + x))));
+    }
+
+    return (_mm_movemask_epi8(_mm_cmpeq_epi8(d, _mm_setzero_si128()))
+        ^ 0xFFFF);
+}
+
+#endif /* TERM_SSE2 */
+
+/*
+ * Shrink the "modified" columns "x1..x2" of row "y" to the first and
+ * last grids which actually differ between "old" and "scr" (comparing
+ * the terrain planes too if "terrain" is set).
+ *
+ * The "x1/x2" ranges only grow between refreshes, and many callers
+ * (Term_load(), Term_exchange(), bigtile redraws) simply mark the whole
+ * row, so this keeps the row routines from scanning unchanged grids.
+ * They skip unchanged grids anyway, so the output is the same.
+ *
+ * Returns FALSE if nothing in the row has changed.
+ */
+static bool Term_fresh_row_diff(int y, int* x1, int* x2, bool terrain)
+{
+    int l = *x1;
+    int r = *x2;
+
+#ifdef TERM_SSE2
+
+    /* Skip unchanged blocks from the left */
+    while (l + 15 <= r)
+    {
+        int m = Term_fresh_diff16(y, l, terrain);
+
+        /* Stop at the first changed grid */
+        if (m)
+        {
+            while (!(m & 1))
+            {
+                m >>= 1;
+                l++;
+            }
+            break;
+        }
+
+        l += 16;
+    }
+
+#endif /* TERM_SSE2 */
+
+    /* Skip unchanged grids from the left */
+    while ((l <= r) && Term_fresh_same(y, l, terrain))
+        l++;
+
+    /* Nothing changed */
+    if (l > r)
+        return (FALSE);
+
+#ifdef TERM_SSE2
+
+    /* Skip unchanged blocks from the right */
+    while (r - 15 > l)
+    {
+        int m = Term_fresh_diff16(y, r - 15, terrain);
+
+        /* Stop at the last changed grid */
+        if (m)
+        {
+            while (!(m & 0x8000))
+            {
+                m <<= 1;
+                r--;
+            }
+            break;
+        }
+
+        r -= 16;
+    }
+
+#endif /* TERM_SSE2 */
+
+    /* Skip unchanged grids from the right (grid "l" has changed) */
+    while (Term_fresh_same(y, r, terrain))
+        r--;
+
+    *x1 = l;
+    *x2 = r;
+
+    return (TRUE);
+}
+
 /*
  * Flush a row of the current window (see "Term_fresh")
  *
@@ -842,6 +1613,109 @@ static void Term_fresh_row_both(int y, int x1, int x2)
     }
 }
 
+/*
+ * Flush a row of the current window (see "Term_fresh")
+ *
+ * Display text using "Term->span_hook", one call per changed span,
+ * but use "Term_pict()" for high-bit attr/char pairs if "both" is set
+ */
+static void Term_fresh_row_span(int y, int x1, int x2, bool both)
+{
+    int x;
+
+    byte* old_aa = Term->old->a[y];
+    char* old_cc = Term->old->c[y];
+    byte* scr_aa = Term->scr->a[y];
+    char* scr_cc = Term->scr->c[y];
+
+    byte* old_taa = Term->old->ta[y];
+    char* old_tcc = Term->old->tc[y];
+    byte* scr_taa = Term->scr->ta[y];
+    char* scr_tcc = Term->scr->tc[y];
+
+    /* Pending span (first and last changed grids) */
+    int fx = -1;
+    int lx = -1;
+
+    byte na;
+    char nc;
+
+    /* Scan "modified" columns */
+    for (x = x1; x <= x2; x++)
+    {
+        bool same;
+
+        /* See what is desired there */
+        na = scr_aa[x];
+        nc = scr_cc[x];
+
+        /* Compare with what is currently here */
+        same = ((na == old_aa[x]) && (nc == old_cc[x]));
+        if (both && same)
+        {
+            same = ((scr_taa[x] == old_taa[x]) && (scr_tcc[x] == old_tcc[x]));
+        }
+
+        /* Handle high-bit attr/chars */
+        if (both && (na & 0x80) && (nc & 0x80))
+        {
+            /* Flush, since the span may not cover this grid */
+            if (fx >= 0)
+            {
+                (void)((*Term->span_hook)(
+                    fx, y, lx - fx + 1, &scr_aa[fx], &scr_cc[fx]));
+                fx = -1;
+            }
+
+            /* Skip unchanged grids */
+            if (same)
+                continue;
+
+            /* Save new contents */
+            old_aa[x] = na;
+            old_cc[x] = nc;
+            old_taa[x] = scr_taa[x];
+            old_tcc[x] = scr_tcc[x];
+
+            /* 2nd byte of bigtile */
+            if ((na == 255) && (nc == -1))
+                continue;
+
+            /* Hack -- Draw the special attr/char pair */
+            (void)((*Term->pict_hook)(
+                x, y, 1, &na, &nc, &scr_taa[x], &scr_tcc[x]));
+
+            /* Skip */
+            continue;
+        }
+
+        /* Unchanged grids stay in the span, if one is pending */
+        if (same)
+            continue;
+
+        /* Save new contents */
+        old_aa[x] = na;
+        old_cc[x] = nc;
+        if (both)
+        {
+            old_taa[x] = scr_taa[x];
+            old_tcc[x] = scr_tcc[x];
+        }
+
+        /* Extend the span */
+        if (fx < 0)
+            fx = x;
+        lx = x;
+    }
+
+    /* Flush */
+    if (fx >= 0)
+    {
+        (void)((*Term->span_hook)(
+            fx, y, lx - fx + 1, &scr_aa[fx], &scr_cc[fx]));
+    }
+}
+
 /*
  * Flush a row of the current window (see "Term_fresh")
  *
@@ -1057,6 +1931,13 @@ static void Term_fresh_row_text(int y, int x1, int x2)
  * This function does nothing unless the "Term" is "mapped", which allows
  * certain systems to optimize the handling of "closed" windows.
  *
+ * The "old" window is the retained copy of what is on the screen, and
+ * every "modified" row is checked against it before anything is drawn.
+ * Most sub-windows are regenerated from scratch (erase, then re-print
+ * every line), so often nothing has really changed; in that case (with
+ * the cursor where it was) no hooks are called at all, not even the
+ * final "Term_xtra(TERM_XTRA_FRESH,0)".
+ *
  * On systems with a "soft" cursor, we must explicitly erase the cursor
  * before flushing the output, if needed, to prevent a "jumpy" refresh.
  * The actual method for this is horrible, but there is very little that
@@ -1089,6 +1970,8 @@ errr Term_fresh(void)
     term_win* old = Term->old;
     term_win* scr = Term->scr;
 
+    bool rec, key = FALSE;
+
     /* Do nothing unless "mapped" */
     if (!Term->mapped_flag)
         return (1);
@@ -1101,6 +1984,48 @@ errr Term_fresh(void)
         return (1);
     }
 
+    /* Damaged Refresh -- skip the rows which did not really change */
+    if (!(Term->total_erase) && (scr->cu == old->cu) && (scr->cv == old->cv)
+        && (scr->cx == old->cx) && (scr->cy == old->cy))
+    {
+        bool terrain = (bool)(Term->always_pict || Term->higher_pict);
+
+        for (y = y1; y <= y2; y++)
+        {
+            int x1 = Term->x1[y];
+            int x2 = Term->x2[y];
+
+            /* Found some damage */
+            if ((x1 <= x2) && Term_fresh_row_diff(y, &x1, &x2, terrain))
+                break;
+
+            /* This row is all done */
+            Term->x1[y] = w;
+            Term->x2[y] = 0;
+        }
+
+        /* Nothing really changed */
+        if (y > y2)
+        {
+            /* No rows are invalid */
+            Term->y1 = h;
+            Term->y2 = 0;
+
+            /* Nothing */
+            return (1);
+        }
+
+        /* Start at the first damaged row */
+        Term->y1 = y1 = y;
+    }
+
+    PROF_ENTER(PROF_TERM_FRESH);
+
+    /* Record the frame, if recording this term */
+    rec = (rec_fp && (Term == rec_term));
+    if (rec)
+        key = Term_record_frame();
+
     /* Paranoia -- use "fake" hooks to prevent core dumps */
     if (!Term->curs_hook)
         Term->curs_hook = Term_curs_hack;
@@ -1243,9 +2168,25 @@ errr Term_fresh(void)
             int x1 = Term->x1[y];
             int x2 = Term->x2[y];
 
+            /* Ignore grids which have not really changed */
+            if ((x1 <= x2)
+                && !Term_fresh_row_diff(y, &x1, &x2,
+                    (bool)(Term->always_pict || Term->higher_pict)))
+            {
+                /* This row is all done */
+                Term->x1[y] = w;
+                Term->x2[y] = 0;
+
+                continue;
+            }
+
             /* Flush each "modified" row */
             if (x1 <= x2)
             {
+                /* Record the changed grids */
+                if (rec && !key)
+                    Term_record_span(y, x1, x2);
+
                 /* Always use "Term_pict()" */
                 if (Term->always_pict)
                 {
@@ -1255,9 +2196,19 @@ errr Term_fresh(void)
 
                 /* Sometimes use "Term_pict()" */
                 else if (Term->higher_pict)
+                {
+                    /* Flush the row, in spans if possible */
+                    if (Term->span_hook)
+                        Term_fresh_row_span(y, x1, x2, TRUE);
+                    else
+                        Term_fresh_row_both(y, x1, x2);
+                }
+
+                /* Never use "Term_pict()", but use spans if possible */
+                else if (Term->span_hook)
                 {
                     /* Flush the row */
-                    Term_fresh_row_both(y, x1, x2);
+                    Term_fresh_row_span(y, x1, x2, FALSE);
                 }
 
                 /* Never use "Term_pict()" */
@@ -1341,9 +2292,15 @@ errr Term_fresh(void)
     old->cx = scr->cx;
     old->cy = scr->cy;
 
+    /* Finish the recorded frame */
+    if (rec)
+        Term_record_flush(key);
+
     /* Actually flush the output */
     Term_xtra(TERM_XTRA_FRESH, 0);
 
+    PROF_LEAVE(PROF_TERM_FRESH);
+
     /* Success */
     return (0);
 }
@@ -1860,6 +2817,10 @@ errr Term_keypress(int k)
     if (!k)
         return (-1);
 
+    /* Record it, if recording this term */
+    if (rec_fp && (Term == rec_term))
+        Term_record_key(k);
+
     /* Store the char, advance the queue */
     Term->key_queue[Term->key_head++] = k;
 
@@ -2310,6 +3271,10 @@ errr Term_activate(term* t)
  */
 errr term_nuke(term* t)
 {
+    /* Stop recording it */
+    if (t == rec_term)
+        (void)Term_record_stop();
+
     /* Hack -- Call the special "nuke" hook */
     if (t->active_flag)
     {
@@ -216,6 +216,8 @@ struct term
 
     errr (*pict_hook)(int x, int y, int n, const byte* ap, const char* cp,
         const byte* tap, const char* tcp);
+
+    errr (*span_hook)(int x, int y, int n, const byte* ap, const char* cp);
 };
 
 /**** Available Constants ****/
@@ -296,6 +298,10 @@ extern errr Term_load(void);
 
 extern errr Term_exchange(void);
 
+extern errr Term_record_start(FILE* fp);
+extern errr Term_record_stop(void);
+extern errr Term_replay(FILE* fp);
+
 extern errr Term_resize(int w, int h);
 
 extern errr Term_activate(term* t);
@@ -255,3 +255,95 @@ void core(cptr str)
     /* Be sure we exited */
     quit("core() failed");
 }
+
+/*
+ * Read the wall clock, in milliseconds
+ */
+double clock_msec(void)
+{
+#ifdef CLOCK_MONOTONIC
+
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0);
+
+#else /* CLOCK_MONOTONIC */
+
+    return (clock() * (1000.0 / CLOCKS_PER_SEC));
+
+#endif /* CLOCK_MONOTONIC */
+}
+
+#ifdef ALLOW_PROFILE
+
+/*
+ * Names of the profiled subsystems
+ */
+cptr prof_name[PROF_MAX] = { "update_view", "update_flow", "update_monsters",
+    "process_monster", "project", "generate_cave", "calc_bonuses",
+    "Term_fresh" };
+
+/*
+ * Number of calls of, and total time (in microseconds) spent in, each
+ * profiled subsystem
+ */
+u32b prof_calls[PROF_MAX];
+double prof_time[PROF_MAX];
+
+/*
+ * Nesting depth and start time of each profiled subsystem
+ */
+static int prof_depth[PROF_MAX];
+static double prof_start[PROF_MAX];
+
+/*
+ * Read a clock, in microseconds
+ */
+static double prof_clock(void)
+{
+    return (clock_msec() * 1000.0);
+}
+
+/*
+ * Start timing a subsystem
+ */
+void prof_enter(int n)
+{
+    prof_calls[n]++;
+
+    /* Only the outermost entry is timed */
+    if (prof_depth[n]++ == 0)
+        prof_start[n] = prof_clock();
+}
+
+/*
+ * Stop timing a subsystem
+ */
+void prof_leave(int n)
+{
+    if (--prof_depth[n] == 0)
+        prof_time[n] += prof_clock() - prof_start[n];
+}
+
+/*
+ * Forget all the counters
+ *
+ * Subsystems currently being timed restart from now.
+ */
+void prof_reset(void)
+{
+    int n;
+
+    double now = prof_clock();
+
+    for (n = 0; n < PROF_MAX; n++)
+    {
+        prof_calls[n] = 0;
+        prof_time[n] = 0.0;
+        prof_start[n] = now;
+    }
+}
+
+#endif /* ALLOW_PROFILE */
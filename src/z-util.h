@@ -55,4 +55,53 @@ extern void quit(cptr str);
 /* Dump core, with optional message */
 extern void core(cptr str);
 
+/* Read the wall clock, in milliseconds */
+extern double clock_msec(void);
+
+/**** Profiling ****/
+
+/*
+ * Subsystems timed by the profiling counters
+ */
+#define PROF_UPDATE_VIEW 0
+#define PROF_UPDATE_FLOW 1
+#define PROF_UPDATE_MONSTERS 2
+#define PROF_PROCESS_MONSTER 3
+#define PROF_PROJECT 4
+#define PROF_GENERATE_CAVE 5
+#define PROF_CALC_BONUSES 6
+#define PROF_TERM_FRESH 7
+#define PROF_MAX 8
+
+/*
+ * The counters are only compiled in when "ALLOW_PROFILE" is defined (add
+ * -D"ALLOW_PROFILE" to CFLAGS); otherwise PROF_ENTER()/PROF_LEAVE() vanish.
+ *
+ * Every PROF_ENTER(n) must be matched by a PROF_LEAVE(n) on each way out.
+ * Nested entries of the same subsystem are only timed once.
+ */
+#ifdef ALLOW_PROFILE
+
+/* Subsystem names, calls, and total time (in microseconds) */
+extern cptr prof_name[PROF_MAX];
+extern u32b prof_calls[PROF_MAX];
+extern double prof_time[PROF_MAX];
+
+/* Start and stop timing a subsystem */
+extern void prof_enter(int n);
+extern void prof_leave(int n);
+
+/* Forget all the counters */
+extern void prof_reset(void);
+
+#define PROF_ENTER(N) prof_enter(N)
+#define PROF_LEAVE(N) prof_leave(N)
+
+#else /* ALLOW_PROFILE */
+
+#define PROF_ENTER(N) ((void)0)
+#define PROF_LEAVE(N) ((void)0)
+
+#endif /* ALLOW_PROFILE */
+
 #endif